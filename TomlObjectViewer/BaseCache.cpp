@@ -0,0 +1,442 @@
+#include "BaseCache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+
+constexpr quint32 diskCacheMagic   = 0x544f4242;    // "TOBB"
+constexpr quint16 diskCacheVersion = 1;
+constexpr int     maxNodeDepth     = 64;
+
+enum class NodeTag : quint8
+{
+        Table,
+        Array,
+        String,
+        Integer,
+        FloatingPoint,
+        Boolean
+};
+
+QString
+normalizedPath(const QString &filePath)
+{
+        const QFileInfo info(filePath);
+        const QString   canonicalPath = info.canonicalFilePath();
+        return canonicalPath.isEmpty() ? info.absoluteFilePath() : canonicalPath;
+}
+
+toml::table
+readToml(const QString &filePath)
+{
+        QFile f(filePath);
+        if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) {
+                throw std::runtime_error("Не удалось открыть файл '" + filePath.toStdString() +
+                                         "'");
+        }
+
+        std::string fileContent = QString::fromUtf8(f.readAll()).toStdString();
+        f.close();
+
+        // Путь сохраняется в source_region узлов
+        return toml::parse(fileContent, filePath.toStdString());
+}
+
+// Наложение производного объекта derived на копию базового result
+void
+mergeInto(toml::table &result, const toml::table &derived)
+{
+        for (auto &&[key, value] : derived) {
+                const std::string_view name = key.str();
+
+                if (name == "extends")
+                        continue;
+
+                if (name == "properties" && value.is_table() && result["properties"].is_table()) {
+                        toml::table &properties = *result["properties"].as_table();
+                        for (auto &&[propertyKey, propertyValue] : *value.as_table()) {
+                                // Переводы наименования объединяются по языкам
+                                if (propertyKey.str() == "name" && propertyValue.is_table() &&
+                                    properties["name"].is_table()) {
+                                        toml::table &names = *properties["name"].as_table();
+                                        for (auto &&[language, translation] :
+                                             *propertyValue.as_table())
+                                                names.insert_or_assign(language, translation);
+                                } else {
+                                        properties.insert_or_assign(propertyKey, propertyValue);
+                                }
+                        }
+                        continue;
+                }
+
+                if (name == "parameters" && value.is_array() && result["parameters"].is_array()) {
+                        toml::array &parameters = *result["parameters"].as_array();
+
+                        std::unordered_map<std::string, size_t> indexById;
+                        for (size_t i = 0; i < parameters.size(); ++i) {
+                                if (auto id = parameters[i].as_table()
+                                                  ? (*parameters[i].as_table())["id"]
+                                                        .value<std::string>()
+                                                  : std::nullopt)
+                                        indexById.emplace(*id, i);
+                        }
+
+                        for (const toml::node &parameter : *value.as_array()) {
+                                const toml::table *parameterTable = parameter.as_table();
+                                const auto id = parameterTable != nullptr
+                                                    ? (*parameterTable)["id"].value<std::string>()
+                                                    : std::nullopt;
+                                const auto it = id ? indexById.find(*id) : indexById.end();
+                                if (it == indexById.end()) {
+                                        if (id)
+                                                indexById.emplace(*id, parameters.size());
+                                        parameters.push_back(parameter);
+                                        continue;
+                                }
+
+                                // Параметр с тем же id: поля производного заменяют поля базового
+                                toml::table &baseParameter = *parameters[it->second].as_table();
+                                for (auto &&[field, fieldValue] : *parameterTable)
+                                        baseParameter.insert_or_assign(field, fieldValue);
+                        }
+                        continue;
+                }
+
+                if (name == "constraints" && value.is_array() && result["constraints"].is_array()) {
+                        toml::array &constraints = *result["constraints"].as_array();
+                        for (const toml::node &constraint : *value.as_array())
+                                constraints.push_back(constraint);
+                        continue;
+                }
+
+                result.insert_or_assign(key, value);
+        }
+}
+
+bool
+writeNode(QDataStream &out, const toml::node &node)
+{
+        switch (node.type()) {
+        case toml::node_type::table: {
+                const toml::table &table = *node.as_table();
+                out << static_cast<quint8>(NodeTag::Table) << quint32(table.size());
+                for (auto &&[key, value] : table) {
+                        out << QByteArray(key.data(), qsizetype(key.length()));
+                        if (!writeNode(out, value))
+                                return false;
+                }
+                return true;
+        }
+        case toml::node_type::array: {
+                const toml::array &array = *node.as_array();
+                out << static_cast<quint8>(NodeTag::Array) << quint32(array.size());
+                for (const toml::node &value : array) {
+                        if (!writeNode(out, value))
+                                return false;
+                }
+                return true;
+        }
+        case toml::node_type::string:
+                out << static_cast<quint8>(NodeTag::String)
+                    << QByteArray::fromStdString(node.as_string()->get());
+                return true;
+        case toml::node_type::integer:
+                out << static_cast<quint8>(NodeTag::Integer) << qint64(node.as_integer()->get());
+                return true;
+        case toml::node_type::floating_point:
+                out << static_cast<quint8>(NodeTag::FloatingPoint)
+                    << node.as_floating_point()->get();
+                return true;
+        case toml::node_type::boolean:
+                out << static_cast<quint8>(NodeTag::Boolean) << node.as_boolean()->get();
+                return true;
+        default:
+                // Даты и время в описаниях объектов не используются; такой
+                // базовый объект просто не сохраняется на диск
+                return false;
+        }
+}
+
+std::unique_ptr<toml::node>
+readNode(QDataStream &in, int depth)
+{
+        if (depth > maxNodeDepth)
+                return nullptr;
+
+        quint8 tag = 0;
+        in >> tag;
+
+        switch (static_cast<NodeTag>(tag)) {
+        case NodeTag::Table: {
+                auto    table = std::make_unique<toml::table>();
+                quint32 count = 0;
+                in >> count;
+                for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+                        QByteArray key;
+                        in >> key;
+                        std::unique_ptr<toml::node> value = readNode(in, depth + 1);
+                        if (!value)
+                                return nullptr;
+                        table->insert(key.toStdString(), std::move(*value));
+                }
+                return table;
+        }
+        case NodeTag::Array: {
+                auto    array = std::make_unique<toml::array>();
+                quint32 count = 0;
+                in >> count;
+                for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+                        std::unique_ptr<toml::node> value = readNode(in, depth + 1);
+                        if (!value)
+                                return nullptr;
+                        array->push_back(std::move(*value));
+                }
+                return array;
+        }
+        case NodeTag::String: {
+                QByteArray value;
+                in >> value;
+                return std::make_unique<toml::value<std::string>>(value.toStdString());
+        }
+        case NodeTag::Integer: {
+                qint64 value = 0;
+                in >> value;
+                return std::make_unique<toml::value<int64_t>>(value);
+        }
+        case NodeTag::FloatingPoint: {
+                double value = 0;
+                in >> value;
+                return std::make_unique<toml::value<double>>(value);
+        }
+        case NodeTag::Boolean: {
+                bool value = false;
+                in >> value;
+                return std::make_unique<toml::value<bool>>(value);
+        }
+        }
+        return nullptr;
+}
+
+}    // namespace
+
+BaseCache &
+BaseCache::instance()
+{
+        static BaseCache cache;
+        return cache;
+}
+
+toml::table
+BaseCache::resolve(const QString &filePath)
+{
+        QStringList      chain;
+        QList<FileStamp> files;
+        return parseWithBase(normalizedPath(filePath), chain, files);
+}
+
+toml::table
+BaseCache::parseWithBase(const QString &filePath, QStringList &chain, QList<FileStamp> &files)
+{
+        chain.append(filePath);
+        files.append(stamp(filePath));
+
+        toml::table parsed = readToml(filePath);
+
+        const toml::node *extends = parsed.get("extends");
+        if (extends == nullptr) {
+                chain.removeLast();
+                return parsed;
+        }
+        if (!extends->is_string()) {
+                throw std::runtime_error("Поле 'extends' должно быть строкой с путём к файлу.");
+        }
+
+        const QString basePath =
+            normalizedPath(QFileInfo(filePath).dir().filePath(
+                QString::fromStdString(extends->value_or<std::string>(""))));
+        const Entry base = resolvedBase(basePath, chain);
+        files.append(base.files);
+
+        toml::table result = *base.table;
+        mergeInto(result, parsed);
+
+        chain.removeLast();
+        return result;
+}
+
+BaseCache::Entry
+BaseCache::resolvedBase(const QString &filePath, QStringList &chain)
+{
+        const auto cycleError = [&chain](const QStringList &rest) {
+                return std::runtime_error("Циклическое наследование объектов: " +
+                                          (chain + rest).join(" -> ").toStdString());
+        };
+
+        if (chain.contains(filePath))
+                throw cycleError({ filePath });
+
+        QMutexLocker           locker(&m_mutex);
+        std::shared_ptr<Slot> &slotRef = m_slots[filePath];
+        if (!slotRef)
+                slotRef = std::make_shared<Slot>();
+        const std::shared_ptr<Slot> baseSlot = slotRef;
+
+        while (baseSlot->loading) {
+                // Объект разбирается другим потоком. Если тот (через цепочку
+                // ожидающих потоков) ждёт объект из нашей цепочки, ожидание
+                // не закончится никогда.
+                QStringList waitPath{ filePath };
+                for (QString node = filePath; m_waitsFor.contains(node);) {
+                        node = m_waitsFor.value(node);
+                        waitPath.append(node);
+                        if (chain.contains(node))
+                                throw cycleError(waitPath);
+                }
+
+                // Первый элемент цепочки - сам загружаемый файл, а не базовый объект
+                const bool isBase = chain.size() > 1;
+                if (isBase)
+                        m_waitsFor.insert(chain.last(), filePath);
+                baseSlot->done.wait(&m_mutex);
+                if (isBase)
+                        m_waitsFor.remove(chain.last());
+        }
+
+        // После неудачного разбора другим потоком объект разбирается заново:
+        // ошибка (в том числе цикл) повторится уже в этом потоке
+        if (baseSlot->entry.table && isFresh(baseSlot->entry.files))
+                return baseSlot->entry;
+
+        baseSlot->loading = true;
+        locker.unlock();
+
+        Entry entry;
+        try {
+                if (!readDiskCache(filePath, &entry)) {
+                        QList<FileStamp> files;
+                        entry.table = std::make_shared<const toml::table>(
+                            parseWithBase(filePath, chain, files));
+                        entry.files = std::move(files);
+                        writeDiskCache(filePath, entry);
+                }
+        } catch (...) {
+                locker.relock();
+                baseSlot->loading = false;
+                baseSlot->done.wakeAll();
+                throw;
+        }
+
+        locker.relock();
+        baseSlot->entry   = entry;
+        baseSlot->loading = false;
+        baseSlot->done.wakeAll();
+        return entry;
+}
+
+BaseCache::FileStamp
+BaseCache::stamp(const QString &filePath)
+{
+        const QFileInfo info(filePath);
+        if (!info.exists())
+                return { filePath, -1, -1 };
+        return { filePath, info.lastModified().toMSecsSinceEpoch(), info.size() };
+}
+
+bool
+BaseCache::isFresh(const QList<FileStamp> &files)
+{
+        for (const FileStamp &file : files) {
+                const FileStamp current = stamp(file.path);
+                if (current.modified != file.modified || current.size != file.size)
+                        return false;
+        }
+        return true;
+}
+
+QString
+BaseCache::diskCachePath(const QString &filePath)
+{
+        const QString cacheLocation =
+            QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        if (cacheLocation.isEmpty())
+                return QString();
+
+        const QByteArray key =
+            QCryptographicHash::hash(filePath.toUtf8(), QCryptographicHash::Sha1).toHex();
+        return cacheLocation + "/bases/" + QString::fromLatin1(key) + ".bin";
+}
+
+bool
+BaseCache::readDiskCache(const QString &filePath, Entry *entry)
+{
+        QFile file(diskCachePath(filePath));
+        if (file.fileName().isEmpty() || !file.open(QIODevice::ReadOnly))
+                return false;
+
+        QDataStream in(&file);
+        in.setVersion(QDataStream::Qt_6_0);
+
+        quint32 magic   = 0;
+        quint16 version = 0;
+        quint32 count   = 0;
+        in >> magic >> version >> count;
+        if (magic != diskCacheMagic || version != diskCacheVersion)
+                return false;
+
+        QList<FileStamp> files;
+        for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+                FileStamp file;
+                in >> file.path >> file.modified >> file.size;
+                files.append(file);
+        }
+        if (in.status() != QDataStream::Ok || files.isEmpty() || files.first().path != filePath ||
+            !isFresh(files))
+                return false;
+
+        std::unique_ptr<toml::node> node = readNode(in, 0);
+        if (!node || !node->is_table() || in.status() != QDataStream::Ok)
+                return false;
+
+        entry->table = std::make_shared<const toml::table>(std::move(*node->as_table()));
+        entry->files = std::move(files);
+        return true;
+}
+
+void
+BaseCache::writeDiskCache(const QString &filePath, const Entry &entry)
+{
+        // Кэш на диске необязателен: ошибки записи не мешают загрузке
+        const QString cachePath = diskCachePath(filePath);
+        if (cachePath.isEmpty() || !QDir().mkpath(QFileInfo(cachePath).absolutePath()))
+                return;
+
+        QSaveFile file(cachePath);
+        if (!file.open(QIODevice::WriteOnly))
+                return;
+
+        QDataStream out(&file);
+        out.setVersion(QDataStream::Qt_6_0);
+
+        out << diskCacheMagic << diskCacheVersion << quint32(entry.files.size());
+        for (const FileStamp &stampedFile : entry.files)
+                out << stampedFile.path << stampedFile.modified << stampedFile.size;
+
+        if (!writeNode(out, *entry.table)) {
+                file.cancelWriting();
+                return;
+        }
+        file.commit();
+}
@@ -0,0 +1,82 @@
+#ifndef BASECACHE_H
+#define BASECACHE_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QWaitCondition>
+
+#include <toml++/toml.h>
+
+#include <memory>
+
+// Наследование объектов: файл объекта может начинаться с
+//
+//   extends = "base.toml"
+//
+// (путь задаётся относительно файла). Свойства базового объекта
+// переопределяются свойствами производного, переводы [properties.name]
+// объединяются, параметры с одинаковым id объединяются по полям, новые
+// параметры и правила [[constraints]] добавляются в конец. Базовый объект
+// может сам наследовать другой.
+//
+// Разрешённые базовые объекты разбираются один раз и хранятся в памяти
+// (общие для всех моделей процесса) и на диске в каталоге кэша приложения.
+// Запись кэша действительна, пока не изменились файлы всей цепочки.
+// Класс потокобезопасен: объекты могут загружаться параллельно.
+class BaseCache
+{
+public:
+        static BaseCache &instance();
+
+        // Разбор файла объекта с подстановкой базовых объектов. Сам файл не
+        // кэшируется. Бросает toml::parse_error или std::runtime_error.
+        toml::table resolve(const QString &filePath);
+
+private:
+        struct FileStamp
+        {
+                QString path;
+                qint64  modified;
+                qint64  size;
+        };
+
+        struct Entry
+        {
+                std::shared_ptr<const toml::table> table;
+                QList<FileStamp>                   files;
+        };
+
+        // Запись на каждый базовый файл. Базовый объект разбирает один поток,
+        // остальные ждут done; поля защищены m_mutex, который во время разбора
+        // не удерживается (см. resolvedBase())
+        struct Slot
+        {
+                Entry          entry;
+                bool           loading = false;
+                QWaitCondition done;
+        };
+
+        BaseCache() = default;
+
+        toml::table parseWithBase(const QString &filePath, QStringList &chain,
+                                  QList<FileStamp> &files);
+        Entry       resolvedBase(const QString &filePath, QStringList &chain);
+
+        static FileStamp stamp(const QString &filePath);
+        static bool      isFresh(const QList<FileStamp> &files);
+        static QString   diskCachePath(const QString &filePath);
+        static bool      readDiskCache(const QString &filePath, Entry *entry);
+        static void      writeDiskCache(const QString &filePath, const Entry &entry);
+
+        QMutex                                m_mutex;
+        QHash<QString, std::shared_ptr<Slot>> m_slots;
+        // Разбираемый базовый объект -> базовый объект, результата которого
+        // ждёт разбирающий его поток. По этому графу обнаруживается цикл
+        // наследования, замкнутый через разные потоки.
+        QHash<QString, QString>               m_waitsFor;
+};
+
+#endif    // BASECACHE_H
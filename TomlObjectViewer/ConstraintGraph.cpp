@@ -0,0 +1,97 @@
+#include "ConstraintGraph.h"
+
+#include <algorithm>
+
+namespace
+{
+
+QSet<QString>
+valueSet(const toml::array &values)
+{
+        QSet<QString> result;
+        result.reserve(qsizetype(values.size()));
+        for (const toml::node &value : values)
+                result.insert(ConstraintGraph::valueToString(value));
+        return result;
+}
+
+}    // namespace
+
+void
+ConstraintGraph::compile(const toml::array &constraints)
+{
+        clear();
+
+        m_rules.reserve(constraints.size());
+        for (const toml::node &constraint : constraints) {
+                const toml::table &table = *constraint.as_table();
+                const toml::table &when  = *table["when"].as_table();
+                const toml::table &then  = *table["then"].as_table();
+
+                Rule rule;
+                rule.source        = valueToString(*when.get("parameter"));
+                rule.whenValues    = valueSet(*when["values"].as_array());
+                rule.target        = valueToString(*then.get("parameter"));
+                rule.allowedValues = valueSet(*then["allowed"].as_array());
+
+                m_rulesByTarget[rule.target].append(int(m_rules.size()));
+                QStringList &dependents = m_dependents[rule.source];
+                if (!dependents.contains(rule.target))
+                        dependents.append(rule.target);
+
+                m_rules.push_back(std::move(rule));
+        }
+}
+
+void
+ConstraintGraph::clear()
+{
+        m_rules.clear();
+        m_rulesByTarget.clear();
+        m_dependents.clear();
+}
+
+const std::vector<ConstraintGraph::Rule> &
+ConstraintGraph::rules() const
+{
+        return m_rules;
+}
+
+QStringList
+ConstraintGraph::dependents(const QString &id) const
+{
+        return m_dependents.value(id);
+}
+
+QStringList
+ConstraintGraph::allowedValues(const QString                                 &target,
+                               const QStringList                             &possibleValues,
+                               const std::function<QString(const QString &)> &valueOf) const
+{
+        const auto it = m_rulesByTarget.constFind(target);
+        if (it == m_rulesByTarget.cend())
+                return possibleValues;
+
+        QStringList allowed = possibleValues;
+        for (const int ruleIndex : it.value()) {
+                const Rule &rule = m_rules[ruleIndex];
+                if (!rule.whenValues.contains(valueOf(rule.source)))
+                        continue;
+
+                allowed.erase(std::remove_if(allowed.begin(),
+                                             allowed.end(),
+                                             [&rule](const QString &value) {
+                                                     return !rule.allowedValues.contains(value);
+                                             }),
+                              allowed.end());
+        }
+        return allowed;
+}
+
+QString
+ConstraintGraph::valueToString(const toml::node &node)
+{
+        if (const auto integer = node.value<int64_t>())
+                return QString::number(*integer);
+        return QString::fromStdString(node.value_or<std::string>(""));
+}
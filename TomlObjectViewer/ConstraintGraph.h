@@ -0,0 +1,58 @@
+#ifndef CONSTRAINTGRAPH_H
+#define CONSTRAINTGRAPH_H
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include <toml++/toml.h>
+
+#include <functional>
+#include <vector>
+
+// Граф зависимостей между параметрами, построенный из правил [[constraints]]:
+//
+//   [[constraints]]
+//   when = { parameter = "процессор", values = ["Intel Core i3"] }
+//   then = { parameter = "объём оперативной памяти", allowed = [4, 8, 16] }
+//
+// Пока значение параметра when.parameter входит в when.values, параметр
+// then.parameter может принимать только значения из then.allowed (в пределах
+// своих possible_values). Правила индексируются по обоим параметрам, поэтому
+// после изменения значения пересчитываются только зависящие от него параметры.
+class ConstraintGraph
+{
+public:
+        struct Rule
+        {
+                QString       source;
+                QSet<QString> whenValues;
+                QString       target;
+                QSet<QString> allowedValues;
+        };
+
+        // Правила должны быть предварительно проверены TreeModel::checkToml()
+        void compile(const toml::array &constraints);
+        void clear();
+
+        const std::vector<Rule> &rules() const;
+        // Параметры, допустимые значения которых зависят от параметра id
+        QStringList              dependents(const QString &id) const;
+
+        // Допустимые значения параметра target при текущих значениях valueOf()
+        QStringList allowedValues(const QString                                 &target,
+                                  const QStringList                             &possibleValues,
+                                  const std::function<QString(const QString &)> &valueOf) const;
+
+        // Строковое представление целого числа или строки из TOML
+        static QString valueToString(const toml::node &node);
+
+private:
+        std::vector<Rule>           m_rules;
+        QHash<QString, QList<int>>  m_rulesByTarget;
+        QHash<QString, QStringList> m_dependents;
+};
+
+#endif    // CONSTRAINTGRAPH_H
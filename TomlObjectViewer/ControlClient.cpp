@@ -0,0 +1,116 @@
+#include "ControlClient.h"
+
+#include <QDeadlineTimer>
+
+ControlClient::ControlClient(QObject *parent) :
+    QObject(parent), m_socket(), m_nextRequestId(1), m_responses()
+{
+        connect(&m_socket, &QLocalSocket::readyRead, this, &ControlClient::readResponses);
+        connect(&m_socket, &QLocalSocket::disconnected, this, &ControlClient::disconnected);
+}
+
+bool
+ControlClient::connectToServer(const QString &serverName, int msecs)
+{
+        m_socket.connectToServer(serverName);
+        return m_socket.waitForConnected(msecs);
+}
+
+void
+ControlClient::disconnectFromServer()
+{
+        m_socket.disconnectFromServer();
+}
+
+QString
+ControlClient::errorString() const
+{
+        return m_socket.errorString();
+}
+
+quint32
+ControlClient::listParameters()
+{
+        return sendRequest(ControlProtocol::Command::ListParameters);
+}
+
+quint32
+ControlClient::get(const QStringList &ids)
+{
+        return sendRequest(ControlProtocol::Command::Get, ids);
+}
+
+quint32
+ControlClient::set(const QList<std::pair<QString, QString>> &values)
+{
+        QStringList arguments;
+        arguments.reserve(values.size() * 2);
+        for (const auto &[id, value] : values)
+                arguments << id << value;
+
+        return sendRequest(ControlProtocol::Command::Set, arguments);
+}
+
+quint32
+ControlClient::subscribe()
+{
+        return sendRequest(ControlProtocol::Command::Subscribe);
+}
+
+quint32
+ControlClient::unsubscribe()
+{
+        return sendRequest(ControlProtocol::Command::Unsubscribe);
+}
+
+bool
+ControlClient::waitForResponse(quint32 requestId, ControlProtocol::Response *response, int msecs)
+{
+        const QDeadlineTimer deadline(msecs);
+
+        while (!m_responses.contains(requestId)) {
+                // Отправленные кадры уходят в сокет только из цикла событий
+                // либо при явном ожидании
+                m_socket.flush();
+                if (m_socket.state() != QLocalSocket::ConnectedState ||
+                    !m_socket.waitForReadyRead(int(deadline.remainingTime()))) {
+                        return false;
+                }
+        }
+
+        *response = m_responses.take(requestId);
+        return true;
+}
+
+quint32
+ControlClient::sendRequest(ControlProtocol::Command command, const QStringList &arguments)
+{
+        const quint32 requestId = m_nextRequestId++;
+
+        QDataStream out(&m_socket);
+        ControlProtocol::prepareStream(out);
+        ControlProtocol::writeRequest(out, { requestId, command, arguments });
+
+        return requestId;
+}
+
+void
+ControlClient::readResponses()
+{
+        QDataStream in(&m_socket);
+        ControlProtocol::prepareStream(in);
+
+        ControlProtocol::Response response;
+        while (ControlProtocol::readResponse(in, &response)) {
+                if (response.status == ControlProtocol::Status::Notification) {
+                        if (response.data.size() == 2)
+                                emit parameterValueChanged(response.data[0], response.data[1]);
+                        continue;
+                }
+
+                m_responses.insert(response.requestId, response);
+        }
+
+        if (in.status() == QDataStream::ReadCorruptData)
+                m_socket.disconnectFromServer();
+}
@@ -0,0 +1,55 @@
+#ifndef CONTROLCLIENT_H
+#define CONTROLCLIENT_H
+
+#include "ControlProtocol.h"
+
+#include <QHash>
+#include <QList>
+#include <QLocalSocket>
+#include <QObject>
+
+#include <utility>
+
+// Клиент сервера управления TomlObjectViewer (см. ControlServer).
+//
+// Методы запросов только отправляют кадр и возвращают номер запроса, поэтому
+// запросы можно отправлять конвейером, не дожидаясь ответов. Ответы копятся
+// в клиенте, пока их не заберут через waitForResponse(), поэтому ответ на
+// каждый отправленный запрос должен быть получен.
+class ControlClient final : public QObject
+{
+        Q_OBJECT
+
+public:
+        explicit ControlClient(QObject *parent = nullptr);
+
+        bool connectToServer(const QString &serverName = ControlProtocol::defaultServerName,
+                             int            msecs      = 3000);
+        void disconnectFromServer();
+        QString errorString() const;
+
+        quint32 listParameters();
+        quint32 get(const QStringList &ids);
+        quint32 set(const QList<std::pair<QString, QString>> &values);
+        quint32 subscribe();
+        quint32 unsubscribe();
+
+        // Ожидает ответ на запрос requestId (если он ещё не получен) и
+        // забирает его из клиента
+        bool waitForResponse(quint32 requestId, ControlProtocol::Response *response,
+                             int msecs = 3000);
+
+signals:
+        void parameterValueChanged(const QString &id, const QString &value);
+        void disconnected();
+
+private:
+        quint32 sendRequest(ControlProtocol::Command command, const QStringList &arguments = {});
+        void    readResponses();
+
+        QLocalSocket                              m_socket;
+        quint32                                   m_nextRequestId;
+        QHash<quint32, ControlProtocol::Response> m_responses;
+};
+
+#endif    // CONTROLCLIENT_H
@@ -0,0 +1,61 @@
+#include "ControlProtocol.h"
+
+namespace ControlProtocol
+{
+
+void
+prepareStream(QDataStream &stream)
+{
+        stream.setVersion(QDataStream::Qt_6_0);
+}
+
+void
+writeRequest(QDataStream &stream, const Request &request)
+{
+        stream << request.id << static_cast<quint8>(request.command) << request.arguments;
+}
+
+void
+writeResponse(QDataStream &stream, const Response &response)
+{
+        stream << response.requestId << static_cast<quint8>(response.status) << response.data;
+}
+
+bool
+readRequest(QDataStream &stream, Request *request)
+{
+        stream.startTransaction();
+
+        quint8 command = 0;
+        stream >> request->id >> command >> request->arguments;
+        request->command = static_cast<Command>(command);
+
+        if (stream.status() == QDataStream::Ok &&
+            (command < static_cast<quint8>(Command::ListParameters) ||
+             command > static_cast<quint8>(Command::Unsubscribe))) {
+                stream.abortTransaction();
+                return false;
+        }
+
+        return stream.commitTransaction();
+}
+
+bool
+readResponse(QDataStream &stream, Response *response)
+{
+        stream.startTransaction();
+
+        quint8 status = 0;
+        stream >> response->requestId >> status >> response->data;
+        response->status = static_cast<Status>(status);
+
+        if (stream.status() == QDataStream::Ok &&
+            status > static_cast<quint8>(Status::Notification)) {
+                stream.abortTransaction();
+                return false;
+        }
+
+        return stream.commitTransaction();
+}
+
+}    // namespace ControlProtocol
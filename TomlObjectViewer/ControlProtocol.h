@@ -0,0 +1,70 @@
+#ifndef CONTROLPROTOCOL_H
+#define CONTROLPROTOCOL_H
+
+#include <QDataStream>
+#include <QString>
+#include <QStringList>
+
+// Протокол локального сервера управления (QLocalServer/QLocalSocket).
+//
+// Запросы и ответы передаются кадрами QDataStream. Клиент может отправить
+// сколько угодно запросов подряд, не дожидаясь ответов: сервер обрабатывает
+// все полученные кадры и отвечает на них в том же порядке одной записью.
+//
+// Аргументы и данные команд:
+//   ListParameters          -> [id, ...]
+//   Get  [id, ...]          -> [value, ...] в порядке запроса
+//   Set  [id, value, ...]   -> [] ; применяется целиком или не применяется
+//   Subscribe/Unsubscribe   -> [] ; после подписки сервер присылает кадры
+//                              Notification с данными [id, value]
+namespace ControlProtocol
+{
+
+inline constexpr char defaultServerName[] = "TomlObjectViewer";
+
+enum class Command : quint8
+{
+        ListParameters = 1,
+        Get,
+        Set,
+        Subscribe,
+        Unsubscribe
+};
+
+enum class Status : quint8
+{
+        Ok = 0,
+        Error,
+        // Уведомление об изменении значения; requestId у него равен 0
+        Notification
+};
+
+struct Request
+{
+        quint32     id = 0;
+        Command     command = Command::ListParameters;
+        QStringList arguments;
+};
+
+struct Response
+{
+        quint32     requestId = 0;
+        Status      status = Status::Ok;
+        // При ошибке содержит единственную строку с описанием причины
+        QStringList data;
+};
+
+void prepareStream(QDataStream &stream);
+
+void writeRequest(QDataStream &stream, const Request &request);
+void writeResponse(QDataStream &stream, const Response &response);
+
+// Читают очередной кадр целиком. Если кадр получен не полностью, возвращают
+// false и оставляют данные в устройстве до следующего вызова; признак
+// повреждённых данных - stream.status() == QDataStream::ReadCorruptData.
+bool readRequest(QDataStream &stream, Request *request);
+bool readResponse(QDataStream &stream, Response *response);
+
+}    // namespace ControlProtocol
+
+#endif    // CONTROLPROTOCOL_H
@@ -0,0 +1,193 @@
+#include "ControlServer.h"
+#include "TreeItem.h"
+#include "TreeModel.h"
+
+#include <QLocalSocket>
+
+#include <utility>
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+
+ControlProtocol::Response
+errorResponse(const QString &message)
+{
+        return { 0, ControlProtocol::Status::Error, { message } };
+}
+
+}    // namespace
+
+ControlServer::ControlServer(TreeModel &model, QObject *parent) :
+    QObject(parent), m_model(model), m_server(), m_subscribers()
+{
+        connect(&m_server, &QLocalServer::newConnection, this, &ControlServer::acceptConnections);
+        connect(&m_model,
+                &TreeModel::parameterValueChanged,
+                this,
+                &ControlServer::notifySubscribers);
+}
+
+bool
+ControlServer::listen(const QString &serverName)
+{
+        m_server.setSocketOptions(QLocalServer::UserAccessOption);
+        if (m_server.listen(serverName))
+                return true;
+        if (m_server.serverError() != QAbstractSocket::AddressInUseError)
+                return false;
+
+        // Сокет мог остаться после аварийного завершения предыдущего экземпляра.
+        // Удаляется он, только если на нём никто не отвечает: сокет работающего
+        // экземпляра не перехватывается.
+        QLocalSocket probe;
+        probe.connectToServer(serverName);
+        if (probe.waitForConnected(500)) {
+                probe.disconnectFromServer();
+                return false;
+        }
+
+        QLocalServer::removeServer(serverName);
+        return m_server.listen(serverName);
+}
+
+QString
+ControlServer::serverName() const
+{
+        return m_server.serverName();
+}
+
+QString
+ControlServer::errorString() const
+{
+        return m_server.errorString();
+}
+
+void
+ControlServer::acceptConnections()
+{
+        while (QLocalSocket *socket = m_server.nextPendingConnection()) {
+                connect(socket, &QLocalSocket::readyRead, this, [this, socket]() {
+                        readRequests(socket);
+                });
+                connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+                        m_subscribers.remove(socket);
+                        socket->deleteLater();
+                });
+        }
+}
+
+void
+ControlServer::readRequests(QLocalSocket *socket)
+{
+        QDataStream in(socket);
+        ControlProtocol::prepareStream(in);
+
+        // Все полученные кадры обрабатываются за один проход, ответы копятся
+        // в буфере и отправляются одной записью
+        QByteArray  replies;
+        QDataStream out(&replies, QIODevice::WriteOnly);
+        ControlProtocol::prepareStream(out);
+
+        ControlProtocol::Request request;
+        while (ControlProtocol::readRequest(in, &request)) {
+                ControlProtocol::Response response = handleRequest(socket, request);
+                response.requestId                 = request.id;
+                ControlProtocol::writeResponse(out, response);
+        }
+
+        if (!replies.isEmpty())
+                socket->write(replies);
+
+        if (in.status() == QDataStream::ReadCorruptData) {
+                // Поток рассинхронизирован, продолжать разбор нельзя
+                m_subscribers.remove(socket);
+                socket->disconnectFromServer();
+        }
+}
+
+ControlProtocol::Response
+ControlServer::handleRequest(QLocalSocket *socket, const ControlProtocol::Request &request)
+{
+        switch (request.command) {
+        case ControlProtocol::Command::ListParameters:
+                return listParameters();
+        case ControlProtocol::Command::Get:
+                return getValues(request.arguments);
+        case ControlProtocol::Command::Set:
+                return setValues(request.arguments);
+        case ControlProtocol::Command::Subscribe:
+                m_subscribers.insert(socket);
+                return {};
+        case ControlProtocol::Command::Unsubscribe:
+                m_subscribers.remove(socket);
+                return {};
+        }
+        return errorResponse(u"Неизвестная команда."_s);
+}
+
+ControlProtocol::Response
+ControlServer::listParameters() const
+{
+        ControlProtocol::Response response;
+
+        const int count = m_model.parameterCount();
+        response.data.reserve(count);
+        for (int row = 0; row < count; ++row)
+                response.data << m_model.parameterItem(row)->getParamId();
+
+        return response;
+}
+
+ControlProtocol::Response
+ControlServer::getValues(const QStringList &ids) const
+{
+        ControlProtocol::Response response;
+        response.data.reserve(ids.size());
+
+        for (const QString &id : ids) {
+                const QModelIndex index = m_model.parameterValueIndex(id);
+                if (!index.isValid())
+                        return errorResponse(u"Параметр '%1' не найден."_s.arg(id));
+
+                response.data << m_model.data(index, Qt::EditRole).toString();
+        }
+
+        return response;
+}
+
+ControlProtocol::Response
+ControlServer::setValues(const QStringList &arguments)
+{
+        if (arguments.size() % 2 != 0)
+                return errorResponse(u"Ожидаются пары идентификатор-значение."_s);
+
+        QList<std::pair<QString, QString>> values;
+        values.reserve(arguments.size() / 2);
+        for (qsizetype i = 0; i < arguments.size(); i += 2)
+                values.append({ arguments[i], arguments[i + 1] });
+
+        // Пакет применяется целиком или не применяется
+        QString error;
+        if (!m_model.setParameterValues(values, &error))
+                return errorResponse(error);
+
+        return {};
+}
+
+void
+ControlServer::notifySubscribers(const QString &id, const QString &value)
+{
+        if (m_subscribers.isEmpty())
+                return;
+
+        QByteArray  frame;
+        QDataStream out(&frame, QIODevice::WriteOnly);
+        ControlProtocol::prepareStream(out);
+        ControlProtocol::writeResponse(out,
+                                       { 0, ControlProtocol::Status::Notification, { id, value } });
+
+        for (QLocalSocket *socket : std::as_const(m_subscribers))
+                socket->write(frame);
+}
@@ -0,0 +1,45 @@
+#ifndef CONTROLSERVER_H
+#define CONTROLSERVER_H
+
+#include "ControlProtocol.h"
+
+#include <QLocalServer>
+#include <QObject>
+#include <QSet>
+
+class QLocalSocket;
+class TreeModel;
+
+// Локальный сервер управления: позволяет другим процессам читать и менять
+// значения параметров открытого объекта (см. ControlProtocol.h).
+// Работает в потоке GUI; каждый запрос обрабатывается за O(число аргументов)
+// через поиск параметров по идентификатору, поэтому цикл событий не блокируется.
+class ControlServer final : public QObject
+{
+        Q_OBJECT
+
+public:
+        explicit ControlServer(TreeModel &model, QObject *parent = nullptr);
+
+        bool    listen(const QString &serverName);
+        QString serverName() const;
+        QString errorString() const;
+
+private slots:
+        void acceptConnections();
+        void notifySubscribers(const QString &id, const QString &value);
+
+private:
+        void                      readRequests(QLocalSocket *socket);
+        ControlProtocol::Response handleRequest(QLocalSocket                   *socket,
+                                                const ControlProtocol::Request &request);
+        ControlProtocol::Response listParameters() const;
+        ControlProtocol::Response getValues(const QStringList &ids) const;
+        ControlProtocol::Response setValues(const QStringList &arguments);
+
+        TreeModel           &m_model;
+        QLocalServer         m_server;
+        QSet<QLocalSocket *> m_subscribers;
+};
+
+#endif    // CONTROLSERVER_H
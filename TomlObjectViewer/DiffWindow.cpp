@@ -0,0 +1,354 @@
+#include "DiffWindow.h"
+#include "TreeItem.h"
+
+#include <QFutureWatcher>
+#include <QLabel>
+#include <QMessageBox>
+#include <QScrollBar>
+#include <QSet>
+#include <QSplitter>
+#include <QTreeView>
+#include <QVBoxLayout>
+#include <QtConcurrent>
+
+namespace
+{
+
+using Marks = QHash<const TreeItem *, TreeModel::DiffMark>;
+
+void
+markSubtree(Marks &marks, const TreeItem *item, TreeModel::DiffMark mark)
+{
+        marks.insert(item, mark);
+        for (int row = 0; row < item->childCount(); ++row)
+                markSubtree(marks, item->child(row), mark);
+}
+
+// Сравнение одного поля двух параметров; a и b - элементы "Значение"
+bool
+sameField(TreeItem::Label label, const TreeItem *a, const TreeItem *b)
+{
+        switch (label) {
+        case TreeItem::Label::Type:
+                return a->getParamType() == b->getParamType();
+        case TreeItem::Label::Required:
+                return a->isParamRequired() == b->isParamRequired();
+        case TreeItem::Label::DefaultValue:
+                return a->getParamDefaultValue() == b->getParamDefaultValue();
+        case TreeItem::Label::PossibleValues: {
+                // Порядок возможных значений не важен
+                const QStringList lhs = a->getParamPossibleValues();
+                const QStringList rhs = b->getParamPossibleValues();
+                return QSet<QString>(lhs.cbegin(), lhs.cend()) ==
+                       QSet<QString>(rhs.cbegin(), rhs.cend());
+        }
+        case TreeItem::Label::Value:
+                return a->getParamValue() == b->getParamValue();
+        default:
+                return true;
+        }
+}
+
+QWidget *
+createPane(QLabel *title, QTreeView *view)
+{
+        auto *pane   = new QWidget;
+        auto *layout = new QVBoxLayout(pane);
+        layout->setContentsMargins(0, 0, 0, 0);
+        layout->addWidget(title);
+        layout->addWidget(view);
+        return pane;
+}
+
+}    // namespace
+
+DiffWindow::DiffWindow(QWidget *parent) :
+    QWidget(parent, Qt::Window), m_leftModel(this), m_rightModel(this),
+    m_leftView(new QTreeView(this)), m_rightView(new QTreeView(this)),
+    m_leftTitle(new QLabel(this)), m_rightTitle(new QLabel(this)), m_summary(new QLabel(this)),
+    m_pendingLoads(0), m_syncingScroll(false)
+{
+        setAttribute(Qt::WA_DeleteOnClose);
+        setWindowTitle(tr("Сравнение объектов"));
+        resize(1200, 700);
+
+        // Панели служат только для просмотра: правка сделала бы отметки неактуальными
+        m_leftModel.lockEdits();
+        m_rightModel.lockEdits();
+
+        m_leftView->setModel(&m_leftModel);
+        m_rightView->setModel(&m_rightModel);
+
+        auto *splitter = new QSplitter(Qt::Horizontal, this);
+        splitter->addWidget(createPane(m_leftTitle, m_leftView));
+        splitter->addWidget(createPane(m_rightTitle, m_rightView));
+
+        auto *layout = new QVBoxLayout(this);
+        layout->setContentsMargins(8, 8, 8, 8);
+        layout->addWidget(splitter);
+        layout->addWidget(m_summary);
+
+        connect(m_leftView->verticalScrollBar(), &QScrollBar::valueChanged, this, [this]() {
+                syncScroll(m_leftView, m_leftModel, m_rightView, m_rightModel);
+        });
+        connect(m_rightView->verticalScrollBar(), &QScrollBar::valueChanged, this, [this]() {
+                syncScroll(m_rightView, m_rightModel, m_leftView, m_leftModel);
+        });
+
+        connect(m_leftView->selectionModel(),
+                &QItemSelectionModel::currentChanged,
+                this,
+                [this](const QModelIndex &current) {
+                        syncCurrent(current, m_leftView, m_leftModel, m_rightView, m_rightModel);
+                });
+        connect(m_rightView->selectionModel(),
+                &QItemSelectionModel::currentChanged,
+                this,
+                [this](const QModelIndex &current) {
+                        syncCurrent(current, m_rightView, m_rightModel, m_leftView, m_leftModel);
+                });
+
+        connect(m_leftView, &QTreeView::expanded, this, [this](const QModelIndex &index) {
+                syncExpanded(index, true, m_leftModel, m_rightView, m_rightModel);
+        });
+        connect(m_leftView, &QTreeView::collapsed, this, [this](const QModelIndex &index) {
+                syncExpanded(index, false, m_leftModel, m_rightView, m_rightModel);
+        });
+        connect(m_rightView, &QTreeView::expanded, this, [this](const QModelIndex &index) {
+                syncExpanded(index, true, m_rightModel, m_leftView, m_leftModel);
+        });
+        connect(m_rightView, &QTreeView::collapsed, this, [this](const QModelIndex &index) {
+                syncExpanded(index, false, m_rightModel, m_leftView, m_leftModel);
+        });
+}
+
+void
+DiffWindow::compare(const QString &leftFilePath, const QString &rightFilePath)
+{
+        m_leftFilePath  = leftFilePath;
+        m_rightFilePath = rightFilePath;
+        m_leftTitle->setText(leftFilePath);
+        m_rightTitle->setText(rightFilePath);
+        m_summary->setText(tr("Загрузка..."));
+
+        m_pendingLoads = 2;
+        const auto startLoad = [this](const QString                 &filePath,
+                                      QFuture<TreeModel::LoadResult> &future) {
+                future        = QtConcurrent::run(&TreeModel::loadFile, filePath);
+                auto *watcher = new QFutureWatcher<TreeModel::LoadResult>(this);
+                connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher]() {
+                        watcher->deleteLater();
+                        if (--m_pendingLoads == 0)
+                                showComparison();
+                });
+                watcher->setFuture(future);
+        };
+        startLoad(leftFilePath, m_leftFuture);
+        startLoad(rightFilePath, m_rightFuture);
+}
+
+void
+DiffWindow::showComparison()
+{
+        TreeModel::LoadResult left  = m_leftFuture.takeResult();
+        TreeModel::LoadResult right = m_rightFuture.takeResult();
+
+        QStringList errors;
+        if (!left.error.isEmpty())
+                errors << m_leftFilePath + ": " + left.error;
+        if (!right.error.isEmpty())
+                errors << m_rightFilePath + ": " + right.error;
+
+        try {
+                if (errors.isEmpty()) {
+                        m_leftModel.reset(m_leftFilePath, std::move(left.parsed));
+                        m_rightModel.reset(m_rightFilePath, std::move(right.parsed));
+                }
+        } catch (const std::runtime_error &e) {
+                errors << TreeModel::loadErrorMessage(e);
+        }
+
+        if (!errors.isEmpty()) {
+                QMessageBox::critical(this, "Ошибка", errors.join('\n'));
+                close();
+                return;
+        }
+
+        // Одинаковый порядок по id выравнивает общие параметры в панелях
+        m_leftModel.sortParameters(TreeModel::SortKey::Id);
+        m_rightModel.sortParameters(TreeModel::SortKey::Id);
+
+        markDifferences();
+
+        for (QTreeView *view : { m_leftView, m_rightView }) {
+                view->expandAll();
+                for (int c = 0; c < view->model()->columnCount(); ++c)
+                        view->resizeColumnToContents(c);
+        }
+}
+
+void
+DiffWindow::markDifferences()
+{
+        Marks leftMarks;
+        Marks rightMarks;
+
+        const auto markChanged = [&leftMarks, &rightMarks](const TreeItem *left,
+                                                           const TreeItem *right) {
+                leftMarks.insert(left, TreeModel::DiffMark::Changed);
+                rightMarks.insert(right, TreeModel::DiffMark::Changed);
+        };
+
+        // Свойства объекта
+        const std::pair<TreeItem::Label, bool> properties[] = {
+                { TreeItem::Label::Id, m_leftModel.objectId() == m_rightModel.objectId() },
+                { TreeItem::Label::Type, m_leftModel.objectType() == m_rightModel.objectType() },
+                { TreeItem::Label::ObjectName,
+                  m_leftModel.objectNames() == m_rightModel.objectNames() },
+        };
+        for (const auto &[label, same] : properties) {
+                if (!same)
+                        markChanged(m_leftModel.propertyItem(label),
+                                    m_rightModel.propertyItem(label));
+        }
+
+        // Параметры сопоставляются по id за O(n) вместо попарного перебора
+        QHash<QString, const TreeItem *> leftById;
+        QHash<QString, const TreeItem *> rightById;
+        leftById.reserve(m_leftModel.parameterCount());
+        rightById.reserve(m_rightModel.parameterCount());
+        for (int row = 0; row < m_leftModel.parameterCount(); ++row) {
+                const TreeItem *item = m_leftModel.parameterItem(row);
+                leftById.insert(item->getParamId(), item);
+        }
+        for (int row = 0; row < m_rightModel.parameterCount(); ++row) {
+                const TreeItem *item = m_rightModel.parameterItem(row);
+                rightById.insert(item->getParamId(), item);
+        }
+
+        int added   = 0;
+        int removed = 0;
+        int changed = 0;
+
+        for (auto it = leftById.cbegin(); it != leftById.cend(); ++it) {
+                const TreeItem *left  = it.value();
+                const TreeItem *right = rightById.value(it.key(), nullptr);
+                if (right == nullptr) {
+                        markSubtree(leftMarks, left->parentItem(), TreeModel::DiffMark::Removed);
+                        ++removed;
+                        continue;
+                }
+
+                // Поля параметра идут в одном и том же порядке в обеих моделях
+                const TreeItem *leftNode  = left->parentItem();
+                const TreeItem *rightNode = right->parentItem();
+                bool            differs   = false;
+                for (int row = 0; row < leftNode->childCount(); ++row) {
+                        const TreeItem *field = leftNode->child(row);
+                        if (!sameField(field->label(), left, right)) {
+                                markChanged(field, rightNode->child(row));
+                                differs = true;
+                        }
+                }
+                if (differs) {
+                        markChanged(leftNode, rightNode);
+                        ++changed;
+                }
+        }
+
+        for (auto it = rightById.cbegin(); it != rightById.cend(); ++it) {
+                if (!leftById.contains(it.key())) {
+                        markSubtree(rightMarks,
+                                    it.value()->parentItem(),
+                                    TreeModel::DiffMark::Added);
+                        ++added;
+                }
+        }
+
+        m_leftModel.setDiffMarks(std::move(leftMarks));
+        m_rightModel.setDiffMarks(std::move(rightMarks));
+
+        m_summary->setText(tr("Добавлено параметров: %1, удалено: %2, изменено: %3.")
+                               .arg(added)
+                               .arg(removed)
+                               .arg(changed));
+}
+
+QModelIndex
+DiffWindow::counterpart(const QModelIndex &index, const TreeModel &sourceModel,
+                        const TreeModel &targetModel)
+{
+        if (!index.isValid())
+                return {};
+
+        // Разделы верхнего уровня совпадают по номеру строки
+        if (!index.parent().isValid())
+                return targetModel.index(index.row(), index.column());
+
+        const QString id = sourceModel.parameterId(index);
+        if (id.isEmpty()) {
+                const QModelIndex parent = counterpart(index.parent(), sourceModel, targetModel);
+                return targetModel.index(index.row(), index.column(), parent);
+        }
+
+        const QModelIndex valueIndex = targetModel.parameterValueIndex(id);
+        if (!valueIndex.isValid())
+                return {};
+
+        // Узел "Параметр" либо одно из его полей (поля идут в одном порядке)
+        const QModelIndex parameterIndex = valueIndex.parent();
+        if (index.parent().parent().isValid())
+                return targetModel.index(index.row(), index.column(), parameterIndex);
+        return parameterIndex.siblingAtColumn(index.column());
+}
+
+void
+DiffWindow::syncCurrent(const QModelIndex &current, QTreeView *sourceView,
+                        const TreeModel &sourceModel, QTreeView *targetView,
+                        const TreeModel &targetModel)
+{
+        const QModelIndex target = counterpart(current, sourceModel, targetModel);
+        if (!target.isValid() || target == targetView->currentIndex())
+                return;
+
+        targetView->setCurrentIndex(target);
+
+        // Панель, в которой выбран элемент, остаётся на месте: вторая
+        // выравнивается по ней и лишь затем, если нужно, докручивается
+        syncScroll(sourceView, sourceModel, targetView, targetModel);
+        m_syncingScroll = true;
+        targetView->scrollTo(target);
+        m_syncingScroll = false;
+}
+
+void
+DiffWindow::syncScroll(QTreeView *sourceView, const TreeModel &sourceModel,
+                       QTreeView *targetView, const TreeModel &targetModel)
+{
+        if (m_syncingScroll)
+                return;
+
+        // Параметр, которого нет во второй панели, пропускается: выравнивается
+        // ближайшая следующая общая строка
+        QModelIndex source = sourceView->indexAt(QPoint(0, 0));
+        QModelIndex target = counterpart(source, sourceModel, targetModel);
+        while (source.isValid() && !target.isValid()) {
+                source = sourceView->indexBelow(source);
+                target = counterpart(source, sourceModel, targetModel);
+        }
+        if (!target.isValid())
+                return;
+
+        m_syncingScroll = true;
+        targetView->scrollTo(target, QAbstractItemView::PositionAtTop);
+        m_syncingScroll = false;
+}
+
+void
+DiffWindow::syncExpanded(const QModelIndex &index, bool expanded, const TreeModel &sourceModel,
+                         QTreeView *targetView, const TreeModel &targetModel)
+{
+        const QModelIndex target = counterpart(index, sourceModel, targetModel);
+        if (target.isValid() && targetView->isExpanded(target) != expanded)
+                targetView->setExpanded(target, expanded);
+}
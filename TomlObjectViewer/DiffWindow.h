@@ -0,0 +1,59 @@
+#ifndef DIFFWINDOW_H
+#define DIFFWINDOW_H
+
+#include "TreeModel.h"
+
+#include <QFuture>
+#include <QWidget>
+
+class QLabel;
+class QTreeView;
+
+// Сравнение двух объектов в двух панелях. Параметры сопоставляются по id
+// через хеш-таблицу; добавленные, удалённые и изменённые свойства, значения
+// и наборы возможных значений подсвечиваются. Прокрутка, текущий параметр и
+// раскрытие узлов в панелях синхронизированы.
+class DiffWindow final : public QWidget
+{
+        Q_OBJECT
+
+public:
+        explicit DiffWindow(QWidget *parent = nullptr);
+
+        // Оба файла разбираются параллельно вне потока GUI
+        void compare(const QString &leftFilePath, const QString &rightFilePath);
+
+private:
+        void showComparison();
+        void markDifferences();
+        void syncCurrent(const QModelIndex &current, QTreeView *sourceView,
+                         const TreeModel &sourceModel, QTreeView *targetView,
+                         const TreeModel &targetModel);
+        // Прокрутка по содержимому: верхняя видимая строка targetView - та же,
+        // что и в sourceView (по id параметра), а не то же значение полосы
+        // прокрутки; число строк в панелях различается на одиночные параметры
+        void syncScroll(QTreeView *sourceView, const TreeModel &sourceModel,
+                        QTreeView *targetView, const TreeModel &targetModel);
+        void syncExpanded(const QModelIndex &index, bool expanded, const TreeModel &sourceModel,
+                          QTreeView *targetView, const TreeModel &targetModel);
+        static QModelIndex counterpart(const QModelIndex &index, const TreeModel &sourceModel,
+                                       const TreeModel &targetModel);
+
+        TreeModel  m_leftModel;
+        TreeModel  m_rightModel;
+        QTreeView *m_leftView;
+        QTreeView *m_rightView;
+        QLabel    *m_leftTitle;
+        QLabel    *m_rightTitle;
+        QLabel    *m_summary;
+
+        QString                        m_leftFilePath;
+        QString                        m_rightFilePath;
+        QFuture<TreeModel::LoadResult> m_leftFuture;
+        QFuture<TreeModel::LoadResult> m_rightFuture;
+        int                            m_pendingLoads;
+        // Панели прокручиваются одна за другой; защита от обратной синхронизации
+        bool                           m_syncingScroll;
+};
+
+#endif    // DIFFWINDOW_H
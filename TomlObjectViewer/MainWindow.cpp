@@ -1,17 +1,26 @@
 #include "MainWindow.h"
+#include "DiffWindow.h"
+#include "ObjectExporter.h"
 #include "TreeItemDelegate.h"
 
 #include "./ui_MainWindow.h"
 
 #include <QFileDialog>
+#include <QFileInfo>
+#include <QFutureWatcher>
 #include <QLocale>
 #include <QMessageBox>
+#include <QtConcurrent>
 
 #include <toml++/toml.hpp>
 
 #include <filesystem>
 
-MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWindow), model(this)
+using namespace Qt::StringLiterals;
+
+MainWindow::MainWindow(QWidget *parent) :
+    QMainWindow(parent), ui(new Ui::MainWindow), model(this), m_controlServer(nullptr),
+    m_loadWatcher(nullptr)
 {
         ui->setupUi(this);
 
@@ -19,8 +28,40 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
 
         connect(ui->actionOpenFile, &QAction::triggered, this, &MainWindow::openFile);
 
+        connect(ui->actionExport, &QAction::triggered, this, &MainWindow::exportFile);
+
+        connect(ui->actionCompare, &QAction::triggered, this, &MainWindow::compareFiles);
+
         connect(ui->actionAbout, &QAction::triggered, this, &MainWindow::about);
 
+        m_sortKeyGroup = new QActionGroup(this);
+        m_sortKeyGroup->setExclusive(true);
+        const std::pair<QAction *, TreeModel::SortKey> sortActions[] = {
+                { ui->actionSortByFileOrder, TreeModel::SortKey::FileOrder },
+                { ui->actionSortById, TreeModel::SortKey::Id },
+                { ui->actionSortByType, TreeModel::SortKey::Type },
+                { ui->actionSortByRequired, TreeModel::SortKey::Required },
+                { ui->actionSortByValue, TreeModel::SortKey::Value },
+        };
+        for (const auto &[action, key] : sortActions) {
+                action->setData(static_cast<int>(key));
+                m_sortKeyGroup->addAction(action);
+        }
+
+        connect(m_sortKeyGroup, &QActionGroup::triggered, this, &MainWindow::sortParameters);
+        connect(ui->actionSortDescending, &QAction::toggled, this, &MainWindow::sortParameters);
+
+        m_languageGroup = new QActionGroup(this);
+        m_languageGroup->setExclusive(true);
+        ui->actionLanguageSystem->setData(QLocale::system().name());
+        ui->actionLanguageRussian->setData(u"ru_RU"_s);
+        ui->actionLanguageEnglish->setData(u"en_US"_s);
+        m_languageGroup->addAction(ui->actionLanguageSystem);
+        m_languageGroup->addAction(ui->actionLanguageRussian);
+        m_languageGroup->addAction(ui->actionLanguageEnglish);
+
+        connect(m_languageGroup, &QActionGroup::triggered, this, &MainWindow::changeLanguage);
+
         ui->treeView->setModel(&model);
         m_treeItemDelegate = new TreeItemDelegate(ui->treeView);
         ui->treeView->setItemDelegateForColumn(2, m_treeItemDelegate);
@@ -29,15 +70,56 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
         for (int c = 0; c < model.columnCount(); ++c)
                 ui->treeView->resizeColumnToContents(c);
         ui->treeView->expandAll();
+
+        // Исходный текст выбранного элемента или места ошибки загрузки
+        m_sourceView = new SourceView(this);
+        m_sourceDock = new QDockWidget(tr("Исходный текст"), this);
+        m_sourceDock->setObjectName(u"sourceDock"_s);
+        m_sourceDock->setWidget(m_sourceView);
+        addDockWidget(Qt::BottomDockWidgetArea, m_sourceDock);
+        ui->menuView->addSeparator();
+        ui->menuView->addAction(m_sourceDock->toggleViewAction());
+
+        connect(ui->treeView->selectionModel(),
+                &QItemSelectionModel::currentChanged,
+                this,
+                &MainWindow::showSource);
+
+        m_statusSummary = new QLabel(this);
+        statusBar()->addPermanentWidget(m_statusSummary);
+        connect(&model, &TreeModel::statusSummaryChanged, this, &MainWindow::updateStatusSummary);
+        updateStatusSummary();
 }
 
 MainWindow::~MainWindow()
 {
+        // Файл экспорта дописывается до конца и при закрытии окна
+        m_exportFuture.waitForFinished();
+        // Разбор не обращается к окну, но использует общий BaseCache
+        if (m_loadWatcher != nullptr)
+                m_loadWatcher->waitForFinished();
+
         delete m_treeItemDelegate;
 
         delete ui;
 }
 
+bool
+MainWindow::startControlServer(const QString &serverName)
+{
+        if (m_controlServer == nullptr)
+                m_controlServer = new ControlServer(model, this);
+
+        if (!m_controlServer->listen(serverName)) {
+                showErrorMessage("Не удалось запустить сервер управления '" + serverName +
+                                 "'. Причина: '" + m_controlServer->errorString() + "'.");
+                return false;
+        }
+
+        statusBar()->showMessage(tr("Сервер управления: %1").arg(m_controlServer->serverName()));
+        return true;
+}
+
 void
 MainWindow::openFile()
 {
@@ -59,22 +141,144 @@ MainWindow::openFile()
                 return;
         }
 
-        try {
-                model.reset(filePath);
-        } catch (const toml::parse_error &err) {
-                std::string what(err.description().begin(), err.description().end());
-                showErrorMessage("Не удалось выполнить разбор файла TOML. Причина: '" +
-                                 QString::fromStdString(what) + "'.");
-        } catch (const std::runtime_error &e) {
-                showErrorMessage(QString::fromStdString(e.what()));
+        openFileAsync(filePath, QtConcurrent::run(&TreeModel::loadFile, filePath));
+}
+
+void
+MainWindow::openFileAsync(const QString &filePath, QFuture<TreeModel::LoadResult> load)
+{
+        // Результат незавершённой загрузки предыдущего файла не нужен
+        delete m_loadWatcher;
+
+        m_loadWatcher = new QFutureWatcher<TreeModel::LoadResult>(this);
+        connect(m_loadWatcher, &QFutureWatcherBase::finished, this, [this, filePath]() {
+                TreeModel::LoadResult result = m_loadWatcher->future().takeResult();
+                m_loadWatcher->deleteLater();
+                m_loadWatcher = nullptr;
+
+                applyLoadResult(filePath, std::move(result));
+        });
+        m_loadWatcher->setFuture(load);
+}
+
+void
+MainWindow::applyLoadResult(const QString &filePath, TreeModel::LoadResult result)
+{
+        // Файл показывается и тогда, когда он не загрузился. Индекс строк
+        // строится в пуле потоков и не задерживает заполнение дерева; место
+        // ошибки выделяется, как только индекс готов, в том числе пока
+        // открыто сообщение об ошибке.
+        m_sourceView->setFile(filePath);
+
+        QString             error       = result.error;
+        toml::source_region errorSource = result.errorSource;
+        if (error.isEmpty()) {
+                try {
+                        model.reset(filePath, std::move(result.parsed));
+                } catch (const std::runtime_error &e) {
+                        error       = TreeModel::loadErrorMessage(e);
+                        errorSource = TreeModel::errorSource(e);
+                }
         }
 
-        ui->treeView->setModel(&model);
-        m_treeItemDelegate = new TreeItemDelegate(ui->treeView);
-        ui->treeView->setItemDelegateForColumn(2, m_treeItemDelegate);
         ui->treeView->expandAll();
         for (int c = 0; c < model.columnCount(); ++c)
                 ui->treeView->resizeColumnToContents(c);
+
+        emit loadFinished(error.isEmpty());
+
+        if (!error.isEmpty()) {
+                showSourceRegion(errorSource);
+                showErrorMessage(error);
+        }
+}
+
+void
+MainWindow::exportFile()
+{
+        if (model.parameterCount() == 0) {
+                showErrorMessage("Нет открытого объекта для экспорта.");
+                return;
+        }
+
+        QString selectedFilter;
+        QString filePath =
+            QFileDialog::getSaveFileName(this,
+                                         tr("Экспорт объекта"),
+                                         QDir::homePath(),
+                                         tr("JSON (*.json);;CSV (*.csv);;TOML (*.toml)"),
+                                         &selectedFilter);
+        if (filePath.isEmpty())
+                return;
+
+        // Если расширение не указано, оно берётся из выбранного фильтра: "JSON (*.json)"
+        if (QFileInfo(filePath).suffix().isEmpty())
+                filePath += "." + selectedFilter.section(' ', 0, 0).toLower();
+
+        const std::optional<ObjectExporter::Format> format =
+            ObjectExporter::formatForPath(filePath);
+        if (!format) {
+                showErrorMessage(
+                    "Неизвестный формат экспорта. Следует использовать расширение .json, .csv "
+                    "или .toml.");
+                return;
+        }
+
+        ui->actionExport->setEnabled(false);
+        statusBar()->showMessage(tr("Экспорт в '%1'...").arg(filePath));
+
+        // Запись идёт в отдельном потоке из снимка состояния на момент
+        // экспорта; модель тем временем можно редактировать
+        m_exportFuture = QtConcurrent::run(
+            [snapshot = model.snapshot(), filePath, format = *format]() -> QString {
+                    try {
+                            ObjectExporter::exportObject(*snapshot, filePath, format);
+                    } catch (const std::runtime_error &e) {
+                            return QString::fromStdString(e.what());
+                    }
+                    return QString();
+            });
+
+        auto *watcher = new QFutureWatcher<QString>(this);
+        connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, filePath]() {
+                ui->actionExport->setEnabled(true);
+
+                const QString error = watcher->result();
+                watcher->deleteLater();
+
+                if (error.isEmpty()) {
+                        statusBar()->showMessage(tr("Объект экспортирован в '%1'.").arg(filePath),
+                                                 5000);
+                } else {
+                        statusBar()->clearMessage();
+                        showErrorMessage(error);
+                }
+        });
+        watcher->setFuture(m_exportFuture);
+}
+
+void
+MainWindow::compareFiles()
+{
+        const QString leftFilePath =
+            QFileDialog::getOpenFileName(this,
+                                         tr("Выберите первый TOML-файл для сравнения"),
+                                         QDir::homePath(),
+                                         tr("Текстовые файлы (*.toml)"));
+        if (leftFilePath.isEmpty())
+                return;
+
+        const QString rightFilePath =
+            QFileDialog::getOpenFileName(this,
+                                         tr("Выберите второй TOML-файл для сравнения"),
+                                         QFileInfo(leftFilePath).absolutePath(),
+                                         tr("Текстовые файлы (*.toml)"));
+        if (rightFilePath.isEmpty())
+                return;
+
+        auto *diffWindow = new DiffWindow(this);
+        diffWindow->show();
+        diffWindow->compare(leftFilePath, rightFilePath);
 }
 
 void
@@ -88,6 +292,80 @@ MainWindow::about()
                               "Программа для просмотра объектов, описанных в формате TOML."));
 }
 
+void
+MainWindow::sortParameters()
+{
+        TreeModel::SortKey key = TreeModel::SortKey::FileOrder;
+        if (const QAction *checkedAction = m_sortKeyGroup->checkedAction())
+                key = static_cast<TreeModel::SortKey>(checkedAction->data().toInt());
+
+        const Qt::SortOrder order =
+            ui->actionSortDescending->isChecked() ? Qt::DescendingOrder : Qt::AscendingOrder;
+
+        model.sortParameters(key, order);
+}
+
+void
+MainWindow::changeLanguage(QAction *action)
+{
+        const QLocale locale(action->data().toString());
+
+        emit languageChangeRequested(locale);
+
+        // Модель не перестраивается: подписи и наименование объекта
+        // вычисляются заново при отрисовке
+        model.setLanguage(locale);
+}
+
+void
+MainWindow::showSource(const QModelIndex &index)
+{
+        showSourceRegion(model.sourceRegion(index));
+}
+
+void
+MainWindow::showSourceRegion(const toml::source_region &region)
+{
+        if (region.begin.line == 0 || !region.path)
+                return;
+
+        // Унаследованные элементы и ошибки в базовом объекте находятся в
+        // другом файле; индексы недавних файлов SourceView хранит сам
+        const QString filePath = QString::fromStdString(*region.path);
+        if (QFileInfo(filePath) != QFileInfo(m_sourceView->filePath()) &&
+            !m_sourceView->setFile(filePath))
+                return;
+
+        m_sourceView->showRegion(region);
+}
+
+void
+MainWindow::changeEvent(QEvent *event)
+{
+        if (event->type() == QEvent::LanguageChange) {
+                ui->retranslateUi(this);
+                m_sourceDock->setWindowTitle(tr("Исходный текст"));
+                updateStatusSummary();
+        }
+
+        QMainWindow::changeEvent(event);
+}
+
+void
+MainWindow::updateStatusSummary()
+{
+        const int errors   = model.statusCount(TreeModel::ParameterStatus::Error);
+        const int warnings = model.statusCount(TreeModel::ParameterStatus::Warning);
+
+        if (model.parameterCount() == 0)
+                m_statusSummary->clear();
+        else if (errors == 0 && warnings == 0)
+                m_statusSummary->setText(tr("Все параметры корректны"));
+        else
+                m_statusSummary->setText(
+                    tr("Ошибки: %1, предупреждения: %2").arg(errors).arg(warnings));
+}
+
 void
 MainWindow::showErrorMessage(const QString &message)
 {
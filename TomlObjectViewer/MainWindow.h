@@ -1,10 +1,18 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include "ControlServer.h"
+#include "SourceView.h"
 #include "TreeItemDelegate.h"
 #include "TreeModel.h"
 
+#include <QActionGroup>
 #include <QContextMenuEvent>
+#include <QDockWidget>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QLabel>
+#include <QLocale>
 #include <QMainWindow>
 
 QT_BEGIN_NAMESPACE
@@ -24,16 +32,59 @@ public:
         MainWindow(QWidget *parent = nullptr);
         ~MainWindow();
 
+        // Запуск локального сервера управления (см. ControlServer)
+        bool startControlServer(const QString &serverName);
+
+        // Показ объекта, разбор которого уже запущен (TreeModel::loadFile()).
+        // Результат незавершённой загрузки другого файла при этом отбрасывается;
+        // сам разбор не прерывается и завершается в пуле потоков.
+        void openFileAsync(const QString &filePath, QFuture<TreeModel::LoadResult> load);
+
+signals:
+        // Запрос на смену перевода интерфейса; обрабатывается в main.cpp,
+        // где находится QTranslator приложения
+        void languageChangeRequested(const QLocale &locale);
+
+        // Загрузка, начатая openFileAsync(), завершена (success == false,
+        // если объект не загружен)
+        void loadFinished(bool success);
+
+protected:
+        void changeEvent(QEvent *event) override;
+
 private slots:
         void openFile();
 
+        void exportFile();
+
+        void compareFiles();
+
         void about();
 
+        void sortParameters();
+
+        void changeLanguage(QAction *action);
+
+        void showSource(const QModelIndex &index);
+
 private:
         void showErrorMessage(const QString &message);
+        void applyLoadResult(const QString &filePath, TreeModel::LoadResult result);
+        void showSourceRegion(const toml::source_region &region);
+        void updateStatusSummary();
 
         Ui::MainWindow   *ui;
         TreeModel         model;
         TreeItemDelegate *m_treeItemDelegate;
+        QActionGroup     *m_sortKeyGroup;
+        QActionGroup     *m_languageGroup;
+        QFuture<QString>  m_exportFuture;
+        ControlServer    *m_controlServer;
+        QDockWidget      *m_sourceDock;
+        SourceView       *m_sourceView;
+        // Итог проверки параметров (TreeModel::statusCount()) в строке состояния
+        QLabel           *m_statusSummary;
+
+        QFutureWatcher<TreeModel::LoadResult> *m_loadWatcher;
 };
 #endif    // MAINWINDOW_H
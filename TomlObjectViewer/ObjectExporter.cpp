@@ -0,0 +1,262 @@
+#include "ObjectExporter.h"
+#include "ObjectSnapshot.h"
+
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QTextStream>
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+
+// Экранирование строки по общим для JSON и TOML правилам (basic string)
+QString
+quoted(const QString &value)
+{
+        QString result;
+        result.reserve(value.size() + 2);
+        result += u'"';
+        for (const QChar ch : value) {
+                switch (ch.unicode()) {
+                case u'"':
+                        result += u"\\\""_s;
+                        break;
+                case u'\\':
+                        result += u"\\\\"_s;
+                        break;
+                case u'\b':
+                        result += u"\\b"_s;
+                        break;
+                case u'\f':
+                        result += u"\\f"_s;
+                        break;
+                case u'\n':
+                        result += u"\\n"_s;
+                        break;
+                case u'\r':
+                        result += u"\\r"_s;
+                        break;
+                case u'\t':
+                        result += u"\\t"_s;
+                        break;
+                default:
+                        if (ch.unicode() < 0x20 || ch.unicode() == 0x7f)
+                                result += u"\\u%1"_s.arg(uint(ch.unicode()), 4, 16, u'0');
+                        else
+                                result += ch;
+                }
+        }
+        result += u'"';
+        return result;
+}
+
+QString
+csvField(const QString &value)
+{
+        if (!value.contains(u',') && !value.contains(u'"') && !value.contains(u'\n') &&
+            !value.contains(u'\r'))
+                return value;
+
+        QString result = value;
+        result.replace(u"\""_s, u"\"\""_s);
+        return u'"' + result + u'"';
+}
+
+QString
+tomlKey(const QString &key)
+{
+        const bool isBare = !key.isEmpty() && std::all_of(key.cbegin(), key.cend(), [](QChar ch) {
+                return (ch >= u'A' && ch <= u'Z') || (ch >= u'a' && ch <= u'z') ||
+                       (ch >= u'0' && ch <= u'9') || ch == u'_' || ch == u'-';
+        });
+        return isBare ? key : quoted(key);
+}
+
+// Значение параметра в синтаксисе JSON/TOML: целые числа без кавычек.
+// Значение, не совпадающее с типом параметра, сохраняется строкой. Без
+// кавычек пишется только каноническая запись числа: "007", "+5" или " 5"
+// toLongLong() принимает, но в JSON и TOML такие литералы недопустимы.
+QString
+literal(const ObjectSnapshot::Parameter &parameter, const QString &value)
+{
+        if (parameter.type == u"integer"_s) {
+                bool         isInteger = false;
+                const qint64 number    = value.toLongLong(&isInteger);
+                if (isInteger && QString::number(number) == value)
+                        return value;
+        }
+        return quoted(value);
+}
+
+QString
+literalList(const ObjectSnapshot::Parameter &parameter, const QStringList &values)
+{
+        QStringList literals;
+        literals.reserve(values.size());
+        for (const QString &value : values)
+                literals << literal(parameter, value);
+        return u"[ "_s + literals.join(u", "_s) + u" ]"_s;
+}
+
+// Переводы наименования: сначала "default", далее по алфавиту
+QStringList
+nameKeys(const QHash<QString, QString> &names)
+{
+        QStringList keys = names.keys();
+        std::sort(keys.begin(), keys.end(), [](const QString &a, const QString &b) {
+                if (a == u"default"_s || b == u"default"_s)
+                        return a == u"default"_s && b != u"default"_s;
+                return a < b;
+        });
+        return keys;
+}
+
+void
+writeJson(const ObjectSnapshot &object, QTextStream &out)
+{
+        const QHash<QString, QString> &names = object.objectNames();
+
+        out << "{\n  \"properties\": {\n";
+        out << "    \"id\": " << quoted(object.objectId()) << ",\n";
+        out << "    \"type\": " << quoted(object.objectType()) << ",\n";
+        out << "    \"name\": {";
+        const QStringList keys = nameKeys(names);
+        for (qsizetype i = 0; i < keys.size(); ++i) {
+                out << (i == 0 ? " " : ", ") << quoted(keys[i]) << ": "
+                    << quoted(names.value(keys[i]));
+        }
+        out << " }\n  },\n  \"parameters\": [\n";
+
+        const int count = object.parameterCount();
+        for (int row = 0; row < count; ++row) {
+                const ObjectSnapshot::Parameter &parameter = object.parameter(row);
+                out << "    { \"id\": " << quoted(parameter.id)
+                    << ", \"type\": " << quoted(parameter.type)
+                    << ", \"required\": " << (parameter.required ? "true" : "false")
+                    << ", \"default_value\": " << literal(parameter, parameter.defaultValue)
+                    << ", \"possible_values\": "
+                    << literalList(parameter, parameter.possibleValues)
+                    << ", \"value\": " << literal(parameter, parameter.value) << " }"
+                    << (row < count - 1 ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+}
+
+// Одна строка на параметр. Список possible_values записывается в одну ячейку
+// литералом массива JSON ([ "a", "b" ]): строки в нём экранированы, поэтому
+// значения с любыми символами, в том числе ';' и ',', разделяются однозначно.
+void
+writeCsv(const ObjectSnapshot &object, QTextStream &out)
+{
+        out << "id,type,required,default_value,possible_values,value\r\n";
+
+        const int count = object.parameterCount();
+        for (int row = 0; row < count; ++row) {
+                const ObjectSnapshot::Parameter &parameter = object.parameter(row);
+                out << csvField(parameter.id) << ',' << csvField(parameter.type) << ','
+                    << (parameter.required ? "true" : "false") << ','
+                    << csvField(parameter.defaultValue) << ','
+                    << csvField(literalList(parameter, parameter.possibleValues)) << ','
+                    << csvField(parameter.value) << "\r\n";
+        }
+}
+
+void
+writeToml(const ObjectSnapshot &object, QTextStream &out)
+{
+        const QHash<QString, QString> &names = object.objectNames();
+
+        out << "[properties]\n";
+        out << "id = " << quoted(object.objectId()) << '\n';
+        out << "type = " << quoted(object.objectType()) << '\n';
+        out << "\n[properties.name]\n";
+        for (const QString &key : nameKeys(names))
+                out << tomlKey(key) << " = " << quoted(names.value(key)) << '\n';
+
+        const int count = object.parameterCount();
+        for (int row = 0; row < count; ++row) {
+                const ObjectSnapshot::Parameter &parameter = object.parameter(row);
+                out << "\n[[parameters]]\n";
+                out << "id = " << quoted(parameter.id) << '\n';
+                out << "type = " << quoted(parameter.type) << '\n';
+                out << "required = " << (parameter.required ? "true" : "false") << '\n';
+                out << "default_value = " << literal(parameter, parameter.defaultValue) << '\n';
+                out << "possible_values = " << literalList(parameter, parameter.possibleValues)
+                    << '\n';
+                out << "value = " << literal(parameter, parameter.value) << '\n';
+        }
+
+        // Правила ссылаются только на существующие параметры (см. checkToml())
+        const auto parameterById =
+            [&object](const QString &id) -> const ObjectSnapshot::Parameter & {
+                    return *object.parameterById(id);
+            };
+        const auto sorted = [](const QSet<QString> &values) {
+                QStringList list = values.values();
+                list.sort();
+                return list;
+        };
+        for (const ConstraintGraph::Rule &rule : object.constraints().rules()) {
+                out << "\n[[constraints]]\n";
+                out << "when = { parameter = " << quoted(rule.source) << ", values = "
+                    << literalList(parameterById(rule.source), sorted(rule.whenValues)) << " }\n";
+                out << "then = { parameter = " << quoted(rule.target) << ", allowed = "
+                    << literalList(parameterById(rule.target), sorted(rule.allowedValues))
+                    << " }\n";
+        }
+}
+
+}    // namespace
+
+std::optional<ObjectExporter::Format>
+ObjectExporter::formatForPath(const QString &filePath)
+{
+        return formatForName(QFileInfo(filePath).suffix());
+}
+
+std::optional<ObjectExporter::Format>
+ObjectExporter::formatForName(const QString &name)
+{
+        const QString lowerName = name.toLower();
+        if (lowerName == u"json"_s)
+                return Format::Json;
+        if (lowerName == u"csv"_s)
+                return Format::Csv;
+        if (lowerName == u"toml"_s)
+                return Format::Toml;
+        return std::nullopt;
+}
+
+void
+ObjectExporter::exportObject(const ObjectSnapshot &object, const QString &filePath, Format format)
+{
+        // QSaveFile заменяет целевой файл только после успешной записи
+        QSaveFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly)) {
+                throw std::runtime_error("Не удалось открыть файл '" + filePath.toStdString() +
+                                         "' для записи.");
+        }
+
+        QTextStream out(&file);
+        switch (format) {
+        case Format::Json:
+                writeJson(object, out);
+                break;
+        case Format::Csv:
+                writeCsv(object, out);
+                break;
+        case Format::Toml:
+                writeToml(object, out);
+                break;
+        }
+        out.flush();
+
+        if (out.status() != QTextStream::Ok || !file.commit()) {
+                throw std::runtime_error("Не удалось записать файл '" + filePath.toStdString() +
+                                         "'.");
+        }
+}
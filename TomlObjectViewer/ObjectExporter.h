@@ -0,0 +1,34 @@
+#ifndef OBJECTEXPORTER_H
+#define OBJECTEXPORTER_H
+
+#include <QString>
+
+#include <optional>
+
+class ObjectSnapshot;
+
+// Потоковая запись состояния объекта (с учётом изменённых значений) в JSON,
+// CSV или TOML. Данные читаются из снимка (TreeModel::snapshot()) за один
+// проход, параметр за параметром, без промежуточной копии документа; запись
+// может идти в любом потоке. В CSV список possible_values занимает одну
+// ячейку и записывается литералом массива JSON.
+class ObjectExporter
+{
+public:
+        enum class Format
+        {
+                Json,
+                Csv,
+                Toml
+        };
+
+        // Определение формата по расширению файла (.json, .csv, .toml)
+        static std::optional<Format> formatForPath(const QString &filePath);
+        static std::optional<Format> formatForName(const QString &name);
+
+        // Бросает std::runtime_error, если файл не удалось записать
+        static void exportObject(const ObjectSnapshot &object, const QString &filePath,
+                                 Format format);
+};
+
+#endif    // OBJECTEXPORTER_H
@@ -0,0 +1,173 @@
+#include "ObjectSnapshot.h"
+
+#include <sstream>
+#include <utility>
+
+namespace
+{
+
+// Размер блока параметров: изменение значения копирует блок целиком
+constexpr int blockSize = 64;
+
+}    // namespace
+
+ObjectSnapshot::ObjectSnapshot() : m_properties(std::make_shared<const Properties>())
+{
+}
+
+std::shared_ptr<const ObjectSnapshot>
+ObjectSnapshot::create(const QString &objectId, const QString &objectType,
+                       const QHash<QString, QString> &objectNames,
+                       const QList<Parameter> &parameters, const ConstraintGraph &constraints)
+{
+        auto properties         = std::make_shared<Properties>();
+        properties->id          = objectId;
+        properties->type        = objectType;
+        properties->names       = objectNames;
+        properties->constraints = constraints;
+        properties->fileOrderById.reserve(parameters.size());
+
+        auto snapshot = std::make_shared<ObjectSnapshot>();
+        snapshot->m_blocks.reserve((parameters.size() + blockSize - 1) / blockSize);
+        snapshot->m_displayOrder.reserve(parameters.size());
+        for (int fileOrder = 0; fileOrder < parameters.size(); ++fileOrder) {
+                if (fileOrder % blockSize == 0) {
+                        snapshot->m_blocks.append(ParameterBlock());
+                        snapshot->m_blocks.last().reserve(blockSize);
+                }
+                snapshot->m_blocks.last().append(
+                    std::make_shared<const Parameter>(parameters.at(fileOrder)));
+                snapshot->m_displayOrder.append(fileOrder);
+                properties->fileOrderById.insert(parameters.at(fileOrder).id, fileOrder);
+        }
+
+        snapshot->m_properties = std::move(properties);
+        return snapshot;
+}
+
+std::shared_ptr<const ObjectSnapshot>
+ObjectSnapshot::fromToml(const toml::table &parsed)
+{
+        QHash<QString, QString> objectNames;
+        if (const toml::table *names = parsed["properties"]["name"].as_table()) {
+                for (const auto &[key, val] : *names) {
+                        objectNames.insert(QString::fromStdString(key.data()),
+                                           QString::fromStdString(val.value_or<std::string>("")));
+                }
+        }
+
+        QList<Parameter> parameters;
+        if (const toml::array *objectParams = parsed["parameters"].as_array()) {
+                parameters.reserve(objectParams->size());
+                for (const toml::node &param : *objectParams) {
+                        const toml::table &paramTable = *param.as_table();
+
+                        QStringList possibleValues;
+                        for (const toml::node &possibleValue :
+                             *paramTable["possible_values"].as_array())
+                                possibleValues.append(valueText(possibleValue));
+
+                        parameters.append(
+                            { QString::fromStdString(paramTable["id"].value_or<std::string>("")),
+                              QString::fromStdString(
+                                  paramTable["type"].value_or<std::string>("")),
+                              paramTable["required"].value_or(false),
+                              valueText(*paramTable.get("default_value")),
+                              possibleValues,
+                              valueText(*paramTable.get("value")) });
+                }
+        }
+
+        ConstraintGraph constraints;
+        if (const toml::array *constraintArray = parsed["constraints"].as_array())
+                constraints.compile(*constraintArray);
+
+        return create(
+            QString::fromStdString(parsed["properties"]["id"].value_or<std::string>("")),
+            QString::fromStdString(parsed["properties"]["type"].value_or<std::string>("")),
+            objectNames,
+            parameters,
+            constraints);
+}
+
+QString
+ObjectSnapshot::valueText(const toml::node &node)
+{
+        if (node.is_integer() || node.is_string())
+                return ConstraintGraph::valueToString(node);
+
+        std::ostringstream out;
+        node.visit([&out](const auto &value) { out << value; });
+        return QString::fromStdString(out.str());
+}
+
+QString
+ObjectSnapshot::objectId() const
+{
+        return m_properties->id;
+}
+
+QString
+ObjectSnapshot::objectType() const
+{
+        return m_properties->type;
+}
+
+const QHash<QString, QString> &
+ObjectSnapshot::objectNames() const
+{
+        return m_properties->names;
+}
+
+const ConstraintGraph &
+ObjectSnapshot::constraints() const
+{
+        return m_properties->constraints;
+}
+
+int
+ObjectSnapshot::parameterCount() const
+{
+        return int(m_displayOrder.size());
+}
+
+const ObjectSnapshot::Parameter &
+ObjectSnapshot::parameter(int row) const
+{
+        return parameterAt(m_displayOrder.at(row));
+}
+
+const ObjectSnapshot::Parameter *
+ObjectSnapshot::parameterById(const QString &id) const
+{
+        const auto it = m_properties->fileOrderById.constFind(id);
+        return it != m_properties->fileOrderById.cend() ? &parameterAt(*it) : nullptr;
+}
+
+std::shared_ptr<const ObjectSnapshot>
+ObjectSnapshot::withValue(int fileOrder, const QString &value) const
+{
+        auto snapshot = std::make_shared<ObjectSnapshot>(*this);
+
+        auto parameter   = std::make_shared<Parameter>(parameterAt(fileOrder));
+        parameter->value = value;
+
+        // Отделяются только список блоков и изменённый блок; остальные блоки
+        // и сами параметры остаются общими с этой версией
+        snapshot->m_blocks[fileOrder / blockSize][fileOrder % blockSize] = std::move(parameter);
+        return snapshot;
+}
+
+std::shared_ptr<const ObjectSnapshot>
+ObjectSnapshot::withDisplayOrder(QList<int> displayOrder) const
+{
+        auto snapshot            = std::make_shared<ObjectSnapshot>(*this);
+        snapshot->m_displayOrder = std::move(displayOrder);
+        return snapshot;
+}
+
+const ObjectSnapshot::Parameter &
+ObjectSnapshot::parameterAt(int fileOrder) const
+{
+        return *m_blocks.at(fileOrder / blockSize).at(fileOrder % blockSize);
+}
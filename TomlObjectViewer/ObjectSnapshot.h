@@ -0,0 +1,86 @@
+#ifndef OBJECTSNAPSHOT_H
+#define OBJECTSNAPSHOT_H
+
+#include "ConstraintGraph.h"
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+
+// Неизменяемое состояние объекта для чтения вне потока GUI (экспорт и т.п.).
+// TreeModel выпускает новую версию при каждом изменении. Версия разделяет с
+// предыдущей всё, что не изменилось: свойства объекта, правила и блоки
+// параметров. Изменение значения копирует один блок и список указателей на
+// блоки, а не все параметры.
+//
+// Снимок берётся в потоке GUI (TreeModel::snapshot()) за O(1) и передаётся
+// рабочему потоку. Его можно читать без блокировок, пока пользователь
+// продолжает редактировать модель.
+class ObjectSnapshot
+{
+public:
+        struct Parameter
+        {
+                QString     id;
+                QString     type;
+                bool        required;
+                QString     defaultValue;
+                QStringList possibleValues;
+                QString     value;
+        };
+
+        ObjectSnapshot();
+
+        // Параметры передаются в порядке следования в файле
+        static std::shared_ptr<const ObjectSnapshot>
+        create(const QString &objectId, const QString &objectType,
+               const QHash<QString, QString> &objectNames, const QList<Parameter> &parameters,
+               const ConstraintGraph &constraints);
+        // Снимок прямо из проверенного файла (TreeModel::parseFile()), без модели
+        static std::shared_ptr<const ObjectSnapshot> fromToml(const toml::table &parsed);
+
+        // Значение из файла в виде строки; целые числа и строки - как в правилах
+        // [[constraints]], остальные типы - в синтаксисе TOML
+        static QString valueText(const toml::node &node);
+
+        QString                        objectId() const;
+        QString                        objectType() const;
+        const QHash<QString, QString> &objectNames() const;
+        const ConstraintGraph         &constraints() const;
+
+        // Параметры перечисляются в порядке отображения в момент снимка
+        int              parameterCount() const;
+        const Parameter &parameter(int row) const;
+        // nullptr, если параметра с таким id нет
+        const Parameter *parameterById(const QString &id) const;
+
+        // Новые версии; fileOrder - номер параметра в файле
+        std::shared_ptr<const ObjectSnapshot> withValue(int fileOrder, const QString &value) const;
+        std::shared_ptr<const ObjectSnapshot> withDisplayOrder(QList<int> displayOrder) const;
+
+private:
+        struct Properties
+        {
+                QString                 id;
+                QString                 type;
+                QHash<QString, QString> names;
+                ConstraintGraph         constraints;
+                // Номер параметра в файле по id
+                QHash<QString, int>     fileOrderById;
+        };
+
+        using ParameterBlock = QList<std::shared_ptr<const Parameter>>;
+
+        const Parameter &parameterAt(int fileOrder) const;
+
+        std::shared_ptr<const Properties> m_properties;
+        // Параметры в порядке файла, блоками по blockSize. Копии QList
+        // разделяют данные, пока одна из них не изменится.
+        QList<ParameterBlock>             m_blocks;
+        QList<int>                        m_displayOrder;
+};
+
+#endif    // OBJECTSNAPSHOT_H
@@ -0,0 +1,372 @@
+#include "SourceView.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QFontDatabase>
+#include <QFutureWatcher>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QtConcurrent>
+
+#include <climits>
+#include <cstring>
+
+namespace
+{
+
+constexpr int textMargin         = 6;
+constexpr int tabWidth           = 8;
+// Сколько файлов остаётся отображёнными вместе с индексами
+constexpr int maxRecentDocuments = 4;
+
+// Табуляция в toml::source_region считается одним столбцом, поэтому она
+// заменяется пробелами только при отрисовке
+QString
+expandTabs(const QString &text)
+{
+        if (!text.contains('\t'))
+                return text;
+
+        QString result;
+        result.reserve(text.size() + tabWidth);
+        for (const QChar c : text) {
+                if (c == '\t')
+                        result.append(QString(tabWidth - result.size() % tabWidth, ' '));
+                else
+                        result.append(c);
+        }
+        return result;
+}
+
+}    // namespace
+
+SourceView::SourceView(QWidget *parent) :
+    QAbstractScrollArea(parent), m_regionBeginLine(-1), m_regionEndLine(-1),
+    m_regionBeginColumn(-1), m_regionEndColumn(-1)
+{
+        setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+        setFocusPolicy(Qt::StrongFocus);
+        verticalScrollBar()->setSingleStep(1);
+}
+
+SourceView::~SourceView() = default;
+
+SourceView::Document::~Document()
+{
+        if (data != nullptr)
+                file.unmap(data);
+}
+
+bool
+SourceView::setFile(const QString &filePath)
+{
+        clear();
+
+        m_document = openDocument(filePath);
+        if (!m_document)
+                return false;
+
+        m_filePath = filePath;
+        updateScrollBars();
+        viewport()->update();
+        return true;
+}
+
+std::shared_ptr<SourceView::Document>
+SourceView::openDocument(const QString &filePath)
+{
+        const QFileInfo info(filePath);
+        const QString   canonicalPath = info.canonicalFilePath();
+        if (canonicalPath.isEmpty())
+                return nullptr;
+        const qint64 modified = info.lastModified().toMSecsSinceEpoch();
+        const qint64 size     = info.size();
+
+        // Недавно открытый и с тех пор не изменённый файл повторно не
+        // отображается и не индексируется
+        for (qsizetype i = 0; i < m_recentDocuments.size(); ++i) {
+                const std::shared_ptr<Document> document = m_recentDocuments.at(i);
+                if (document->canonicalPath != canonicalPath)
+                        continue;
+
+                m_recentDocuments.removeAt(i);
+                if (document->modified == modified && document->size == size) {
+                        m_recentDocuments.prepend(document);
+                        return document;
+                }
+                break;
+        }
+
+        auto document           = std::make_shared<Document>();
+        document->canonicalPath = canonicalPath;
+        document->modified      = modified;
+        document->size          = size;
+        document->file.setFileName(canonicalPath);
+        if (!document->file.open(QIODevice::ReadOnly))
+                return nullptr;
+        if (size > 0) {
+                document->data = document->file.map(0, size);
+                if (document->data == nullptr)
+                        return nullptr;
+        }
+
+        m_recentDocuments.prepend(document);
+        if (m_recentDocuments.size() > maxRecentDocuments)
+                m_recentDocuments.removeLast();
+
+        // Отображение в память не читает файл; проход по всему файлу для
+        // индекса строк выполняется вне потока GUI, поэтому не задерживает
+        // показ объекта при загрузке
+        auto                         *watcher = new QFutureWatcher<LineIndex>(this);
+        const std::weak_ptr<Document> weakDocument(document);
+        connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, weakDocument]() {
+                watcher->deleteLater();
+                // Документ, вытесненный из недавних и закрытый, индекс не получает
+                if (const std::shared_ptr<Document> indexed = weakDocument.lock())
+                        indexReady(indexed, watcher->result());
+        });
+        watcher->setFuture(QtConcurrent::run(&SourceView::buildIndex,
+                                             std::shared_ptr<const Document>(document)));
+        return document;
+}
+
+SourceView::LineIndex
+SourceView::buildIndex(std::shared_ptr<const Document> document)
+{
+        LineIndex index;
+
+        // Единственный проход по файлу: начала строк и длина самой длинной
+        // строки (для полосы горизонтальной прокрутки)
+        index.offsets.append(0);
+        const char *begin = reinterpret_cast<const char *>(document->data);
+        const char *end   = begin + document->size;
+        for (const char *p = begin; p < end;) {
+                const auto *newline = static_cast<const char *>(std::memchr(p, '\n', end - p));
+                const char *next    = newline != nullptr ? newline + 1 : end;
+                index.maxLineLength = qMax(index.maxLineLength, qint64(next - p));
+                index.offsets.append(next - begin);
+                p = next;
+        }
+        // Последняя строка без перевода строки или пустой файл
+        if (index.offsets.size() == 1 || index.offsets.last() != document->size)
+                index.offsets.append(document->size);
+
+        return index;
+}
+
+void
+SourceView::indexReady(const std::shared_ptr<Document> &document, LineIndex index)
+{
+        document->lineOffsets   = std::move(index.offsets);
+        document->maxLineLength = index.maxLineLength;
+        if (document != m_document)
+                return;
+
+        updateScrollBars();
+        viewport()->update();
+
+        if (m_pendingRegion) {
+                const toml::source_region region = *m_pendingRegion;
+                m_pendingRegion.reset();
+                showRegion(region);
+        }
+}
+
+void
+SourceView::clear()
+{
+        // Документ не закрывается: он остаётся среди недавних, а пока строится
+        // его индекс, им владеет и поток пула
+        m_document.reset();
+        m_filePath.clear();
+        m_pendingRegion.reset();
+
+        m_regionBeginLine   = -1;
+        m_regionEndLine     = -1;
+        m_regionBeginColumn = -1;
+        m_regionEndColumn   = -1;
+
+        verticalScrollBar()->setValue(0);
+        horizontalScrollBar()->setValue(0);
+        updateScrollBars();
+        viewport()->update();
+}
+
+const QString &
+SourceView::filePath() const
+{
+        return m_filePath;
+}
+
+int
+SourceView::lineCount() const
+{
+        if (!m_document || m_document->lineOffsets.isEmpty())
+                return 0;
+        return int(m_document->lineOffsets.size() - 1);
+}
+
+void
+SourceView::showRegion(const toml::source_region &region)
+{
+        if (region.begin.line == 0)
+                return;
+        if (lineCount() == 0) {
+                // Индекс открытого файла ещё строится
+                if (!m_filePath.isEmpty())
+                        m_pendingRegion = region;
+                return;
+        }
+
+        const int lastLine  = lineCount() - 1;
+        m_regionBeginLine   = qMin(int(region.begin.line) - 1, lastLine);
+        m_regionEndLine     = qBound(m_regionBeginLine, int(region.end.line) - 1, lastLine);
+        m_regionBeginColumn = qMax(1, int(region.begin.column));
+        m_regionEndColumn   = region.end.line == region.begin.line ? int(region.end.column) : -1;
+
+        // Фрагмент, который уже виден целиком, не прокручивается
+        const int firstVisible = verticalScrollBar()->value();
+        const int visibleLines = visibleLineCount();
+        if (m_regionBeginLine < firstVisible || m_regionEndLine >= firstVisible + visibleLines)
+                verticalScrollBar()->setValue(m_regionBeginLine - visibleLines / 3);
+
+        const int textWidth = viewport()->width() - gutterWidth() - textMargin;
+        const int x         = columnX(lineText(m_regionBeginLine), m_regionBeginColumn);
+        if (x < horizontalScrollBar()->value() ||
+            x >= horizontalScrollBar()->value() + textWidth)
+                horizontalScrollBar()->setValue(x < textWidth ? 0 : x - textWidth / 3);
+
+        viewport()->update();
+}
+
+void
+SourceView::paintEvent(QPaintEvent *event)
+{
+        QPainter painter(viewport());
+        painter.fillRect(event->rect(), palette().base());
+
+        const QFontMetrics metrics    = fontMetrics();
+        const int          lineHeight = metrics.lineSpacing();
+        const int          gutter     = gutterWidth();
+        const int          textLeft   = gutter + textMargin - horizontalScrollBar()->value();
+        const int          firstLine  = verticalScrollBar()->value();
+        const int          endLine    = qMin(lineCount(), firstLine + visibleLineCount() + 1);
+
+        QColor regionColor = palette().highlight().color();
+        regionColor.setAlpha(60);
+
+        for (int line = firstLine; line < endLine; ++line) {
+                const int     y       = (line - firstLine) * lineHeight;
+                const QString rawText = lineText(line);
+
+                if (line >= m_regionBeginLine && line <= m_regionEndLine) {
+                        painter.fillRect(QRect(gutter, y, viewport()->width() - gutter, lineHeight),
+                                         regionColor);
+
+                        // Фрагмент в одной строке (место ошибки, значение поля)
+                        // выделяется ещё и по столбцам
+                        if (m_regionEndColumn != -1) {
+                                const int left  = columnX(rawText, m_regionBeginColumn);
+                                const int right = m_regionEndColumn > m_regionBeginColumn
+                                                      ? columnX(rawText, m_regionEndColumn)
+                                                      : left + metrics.horizontalAdvance(' ');
+                                painter.fillRect(
+                                    QRect(textLeft + left, y, right - left, lineHeight),
+                                    regionColor);
+                        }
+                }
+
+                painter.setPen(palette().text().color());
+                painter.drawText(textLeft, y + metrics.ascent(), expandTabs(rawText));
+        }
+
+        // Номера строк рисуются поверх текста, сдвинутого прокруткой влево
+        painter.fillRect(QRect(0, 0, gutter, viewport()->height()), palette().window());
+        painter.setPen(palette().placeholderText().color());
+        for (int line = firstLine; line < endLine; ++line) {
+                painter.drawText(QRect(0, (line - firstLine) * lineHeight, gutter - textMargin,
+                                       lineHeight),
+                                 Qt::AlignRight | Qt::AlignVCenter,
+                                 QString::number(line + 1));
+        }
+}
+
+void
+SourceView::resizeEvent(QResizeEvent *event)
+{
+        QAbstractScrollArea::resizeEvent(event);
+        updateScrollBars();
+}
+
+void
+SourceView::changeEvent(QEvent *event)
+{
+        if (event->type() == QEvent::FontChange) {
+                updateScrollBars();
+                viewport()->update();
+        }
+
+        QAbstractScrollArea::changeEvent(event);
+}
+
+void
+SourceView::scrollContentsBy(int, int)
+{
+        // Положение полос прокрутки задаётся в строках, а не в пикселях,
+        // поэтому содержимое не сдвигается, а перерисовывается
+        viewport()->update();
+}
+
+QString
+SourceView::lineText(int line) const
+{
+        const QList<qint64> &offsets = m_document->lineOffsets;
+        const uchar         *data    = m_document->data;
+
+        qint64 begin = offsets.at(line);
+        qint64 end   = offsets.at(line + 1);
+        while (end > begin && (data[end - 1] == '\n' || data[end - 1] == '\r'))
+                --end;
+
+        return QString::fromUtf8(reinterpret_cast<const char *>(data) + begin, end - begin);
+}
+
+int
+SourceView::columnX(const QString &rawText, int column) const
+{
+        // Столбец отсчитывается по исходной строке, где табуляция - один
+        // столбец, и лишь затем переводится в отображаемую ширину
+        return fontMetrics().horizontalAdvance(expandTabs(rawText.left(column - 1)));
+}
+
+int
+SourceView::gutterWidth() const
+{
+        const int digits = int(QString::number(qMax(1, lineCount())).size());
+        return 2 * textMargin + digits * fontMetrics().horizontalAdvance('9');
+}
+
+int
+SourceView::visibleLineCount() const
+{
+        return qMax(1, viewport()->height() / fontMetrics().lineSpacing());
+}
+
+void
+SourceView::updateScrollBars()
+{
+        const int visibleLines = visibleLineCount();
+        verticalScrollBar()->setRange(0, qMax(0, lineCount() - visibleLines));
+        verticalScrollBar()->setPageStep(visibleLines);
+
+        // Ширина оценивается по длине самой длинной строки в байтах, без
+        // декодирования всего файла; для кириллицы оценка завышена
+        const int    charWidth     = fontMetrics().averageCharWidth();
+        const int    textWidth     = qMax(0, viewport()->width() - gutterWidth() - textMargin);
+        const qint64 maxLineLength = m_document ? m_document->maxLineLength : 0;
+        const int    maxWidth      = int(qMin(maxLineLength * charWidth, qint64(INT_MAX / 2)));
+        horizontalScrollBar()->setRange(0, qMax(0, maxWidth - textWidth));
+        horizontalScrollBar()->setPageStep(textWidth);
+        horizontalScrollBar()->setSingleStep(charWidth);
+}
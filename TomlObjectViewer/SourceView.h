@@ -0,0 +1,97 @@
+#ifndef SOURCEVIEW_H
+#define SOURCEVIEW_H
+
+#include <QAbstractScrollArea>
+#include <QFile>
+#include <QList>
+
+#include <toml++/toml.h>
+
+#include <memory>
+#include <optional>
+
+// Просмотр исходного текста объекта только для чтения. Файл отображается в
+// память, и при открытии один раз строится индекс начал строк (в пуле
+// потоков, чтобы не задерживать поток GUI). Несколько недавно открытых
+// файлов остаются отображёнными вместе с индексами: у производного объекта
+// элементы ссылаются то на его файл, то на файл базового. Переход к строке
+// выполняется за O(1), а декодируются и рисуются только видимые строки,
+// поэтому большие файлы не загружаются в QTextDocument.
+class SourceView final : public QAbstractScrollArea
+{
+        Q_OBJECT
+
+public:
+        explicit SourceView(QWidget *parent = nullptr);
+        ~SourceView() override;
+
+        // Отображает файл в память и запускает построение индекса строк (если
+        // файл не открывался недавно); до его завершения lineCount() == 0
+        bool           setFile(const QString &filePath);
+        void           clear();
+        const QString &filePath() const;
+        int            lineCount() const;
+
+        // Выделение фрагмента и прокрутка к нему. Строки и столбцы нумеруются
+        // с 1, как в toml::source_region; путь фрагмента не проверяется.
+        // Пока индекс строится, фрагмент откладывается до его готовности.
+        void showRegion(const toml::source_region &region);
+
+protected:
+        void paintEvent(QPaintEvent *event) override;
+        void resizeEvent(QResizeEvent *event) override;
+        void changeEvent(QEvent *event) override;
+        void scrollContentsBy(int dx, int dy) override;
+
+private:
+        // Отображённый в память файл и его индекс строк. Поток, строящий
+        // индекс, владеет документом наравне с просмотром, поэтому документ
+        // можно закрыть, не дожидаясь окончания прохода.
+        struct Document
+        {
+                ~Document();
+
+                QString       canonicalPath;
+                qint64        modified = 0;
+                qint64        size     = 0;
+                QFile         file;
+                uchar        *data = nullptr;
+                // Смещения начал строк в байтах; строка i занимает
+                // [lineOffsets[i], lineOffsets[i + 1]). Пусто, пока индекс строится.
+                QList<qint64> lineOffsets;
+                qint64        maxLineLength = 0;
+        };
+
+        struct LineIndex
+        {
+                QList<qint64> offsets;
+                qint64        maxLineLength = 0;
+        };
+
+        std::shared_ptr<Document> openDocument(const QString &filePath);
+        static LineIndex          buildIndex(std::shared_ptr<const Document> document);
+        void                      indexReady(const std::shared_ptr<Document> &document,
+                                             LineIndex                        index);
+
+        QString lineText(int line) const;
+        // Смещение столбца column строки rawText (без замены табуляции)
+        int     columnX(const QString &rawText, int column) const;
+        int     gutterWidth() const;
+        int     visibleLineCount() const;
+        void    updateScrollBars();
+
+        // Показываемый файл (пустой указатель, если его нет)
+        std::shared_ptr<Document>        m_document;
+        // Недавно открытые файлы; первый - использованный последним
+        QList<std::shared_ptr<Document>> m_recentDocuments;
+        QString                          m_filePath;
+        // Выделенный фрагмент: строки с 0, столбцы с 1; -1, если его нет
+        int                              m_regionBeginLine;
+        int                              m_regionEndLine;
+        int                              m_regionBeginColumn;
+        int                              m_regionEndColumn;
+
+        std::optional<toml::source_region> m_pendingRegion;
+};
+
+#endif    // SOURCEVIEW_H
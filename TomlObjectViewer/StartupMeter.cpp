@@ -0,0 +1,113 @@
+#include "StartupMeter.h"
+#include "MainWindow.h"
+
+#include <QAbstractItemView>
+#include <QCoreApplication>
+#include <QFile>
+#include <QTextStream>
+#include <QTimer>
+
+#include <cstdlib>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+using namespace Qt::StringLiterals;
+
+StartupMeter::StartupMeter(const QElapsedTimer &mainTimer, MainWindow *window,
+                           bool waitForObject) :
+    QObject(window), m_mainTimer(mainTimer), m_window(window),
+    m_view(window->findChild<QAbstractItemView *>(u"treeView"_s)),
+    m_waitForObject(waitForObject), m_painted(false)
+{
+        m_window->installEventFilter(this);
+        if (m_view != nullptr)
+                m_view->viewport()->installEventFilter(this);
+
+        connect(m_window, &MainWindow::loadFinished, this, [this](bool success) {
+                if (!success) {
+                        report(u"Объект не загружен"_s);
+                        finish(EXIT_FAILURE);
+                }
+        });
+}
+
+bool
+StartupMeter::eventFilter(QObject *watched, QEvent *event)
+{
+        if (event->type() != QEvent::Paint)
+                return QObject::eventFilter(watched, event);
+
+        // Время снимается после того, как кадр целиком отрисован
+        if (!m_painted && watched == m_window) {
+                m_painted = true;
+                QTimer::singleShot(0, this, [this]() {
+                        report(u"Первая отрисовка"_s);
+                        if (!m_waitForObject)
+                                finish(EXIT_SUCCESS);
+                });
+        } else if (m_waitForObject && m_view != nullptr && watched == m_view->viewport() &&
+                   m_view->model()->rowCount() > 0) {
+                m_waitForObject = false;
+                QTimer::singleShot(0, this, [this]() {
+                        report(u"Первый кадр с объектом"_s);
+                        finish(EXIT_SUCCESS);
+                });
+        }
+        return QObject::eventFilter(watched, event);
+}
+
+void
+StartupMeter::report(const QString &what)
+{
+        QTextStream err(stderr);
+        err << what << u": "_s << QString::number(m_mainTimer.nsecsElapsed() / 1e6, 'f', 1)
+            << u" мс от начала main()"_s;
+
+        const qint64 age = processAge();
+        if (age >= 0)
+                err << u", "_s << age << u" мс от запуска процесса"_s;
+        err << '\n';
+}
+
+void
+StartupMeter::finish(int exitCode)
+{
+        m_window->removeEventFilter(this);
+        if (m_view != nullptr)
+                m_view->viewport()->removeEventFilter(this);
+
+        QCoreApplication::exit(exitCode);
+}
+
+qint64
+StartupMeter::processAge()
+{
+#ifdef Q_OS_LINUX
+        // Время запуска процесса (поле 22 в /proc/self/stat) задано в тактах
+        // системных часов с момента загрузки системы, поэтому оно сравнивается
+        // с /proc/uptime; точность - один такт (обычно 10 мс)
+        QFile stat(u"/proc/self/stat"_s);
+        QFile uptime(u"/proc/uptime"_s);
+        if (!stat.open(QIODevice::ReadOnly) || !uptime.open(QIODevice::ReadOnly))
+                return -1;
+
+        // Имя процесса в скобках может содержать пробелы; после него идёт поле 3
+        const QByteArray        statLine = stat.readAll();
+        const QList<QByteArray> fields = statLine.mid(statLine.lastIndexOf(')') + 2).split(' ');
+        if (fields.size() < 20)
+                return -1;
+
+        bool         ok             = false;
+        const qint64 startTicks     = fields.at(19).toLongLong(&ok);
+        const long   ticksPerSecond = sysconf(_SC_CLK_TCK);
+        if (!ok || ticksPerSecond <= 0)
+                return -1;
+
+        const double uptimeSeconds = uptime.readAll().split(' ').first().toDouble();
+        return qint64(uptimeSeconds * 1000) - startTicks * 1000 / ticksPerSecond;
+#else
+        return -1;
+#endif
+}
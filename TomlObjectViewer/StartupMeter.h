@@ -0,0 +1,39 @@
+#ifndef STARTUPMETER_H
+#define STARTUPMETER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+
+class MainWindow;
+class QAbstractItemView;
+
+// Замер задержки запуска (--measure-startup): время до первой отрисовки
+// окна и до первого кадра с загруженным объектом. Время отсчитывается от
+// начала main() и, в Linux, от запуска процесса. Результат выводится в
+// stderr, после чего приложение завершается.
+class StartupMeter final : public QObject
+{
+        Q_OBJECT
+
+public:
+        // waitForObject: дождаться кадра с объектом, загрузка которого
+        // запущена openFileAsync()
+        StartupMeter(const QElapsedTimer &mainTimer, MainWindow *window, bool waitForObject);
+
+protected:
+        bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+        void report(const QString &what);
+        void finish(int exitCode);
+
+        static qint64 processAge();
+
+        QElapsedTimer      m_mainTimer;
+        MainWindow        *m_window;
+        QAbstractItemView *m_view;
+        bool               m_waitForObject;
+        bool               m_painted;
+};
+
+#endif    // STARTUPMETER_H
@@ -0,0 +1,285 @@
+<?xml version="1.0" encoding="utf-8"?>
+<!DOCTYPE TS>
+<TS version="2.1" language="en_US" sourcelanguage="ru_RU">
+<context>
+    <name>MainWindow</name>
+    <message>
+        <source>Файл</source>
+        <translation>File</translation>
+    </message>
+    <message>
+        <source>Вид</source>
+        <translation>View</translation>
+    </message>
+    <message>
+        <source>Сортировка параметров</source>
+        <translation>Sort parameters</translation>
+    </message>
+    <message>
+        <source>Язык</source>
+        <translation>Language</translation>
+    </message>
+    <message>
+        <source>Справка</source>
+        <translation>Help</translation>
+    </message>
+    <message>
+        <source>Открыть</source>
+        <translation>Open</translation>
+    </message>
+    <message>
+        <source>Открыть TOML-файл объекта.</source>
+        <translation>Open an object TOML file.</translation>
+    </message>
+    <message>
+        <source>Выход из программы</source>
+        <translation>Quit</translation>
+    </message>
+    <message>
+        <source>Завершить работу программы и выйти.</source>
+        <translation>Quit the program.</translation>
+    </message>
+    <message>
+        <source>О программе</source>
+        <translation>About</translation>
+    </message>
+    <message>
+        <source>О программе TomlObjectViewer.</source>
+        <translation>About TomlObjectViewer.</translation>
+    </message>
+    <message>
+        <source>В порядке следования в файле</source>
+        <translation>In file order</translation>
+    </message>
+    <message>
+        <source>Показывать параметры в том порядке, в котором они описаны в файле.</source>
+        <translation>Show parameters in the order they are declared in the file.</translation>
+    </message>
+    <message>
+        <source>По идентификатору</source>
+        <translation>By id</translation>
+    </message>
+    <message>
+        <source>Упорядочить параметры по идентификатору.</source>
+        <translation>Sort parameters by id.</translation>
+    </message>
+    <message>
+        <source>По типу</source>
+        <translation>By type</translation>
+    </message>
+    <message>
+        <source>Упорядочить параметры по типу.</source>
+        <translation>Sort parameters by type.</translation>
+    </message>
+    <message>
+        <source>По признаку обязательности</source>
+        <translation>By required flag</translation>
+    </message>
+    <message>
+        <source>Упорядочить параметры по признаку обязательности.</source>
+        <translation>Sort parameters by required flag.</translation>
+    </message>
+    <message>
+        <source>По текущему значению</source>
+        <translation>By current value</translation>
+    </message>
+    <message>
+        <source>Упорядочить параметры по текущему значению.</source>
+        <translation>Sort parameters by current value.</translation>
+    </message>
+    <message>
+        <source>По убыванию</source>
+        <translation>Descending</translation>
+    </message>
+    <message>
+        <source>Упорядочить параметры по убыванию.</source>
+        <translation>Sort parameters in descending order.</translation>
+    </message>
+    <message>
+        <source>Язык системы</source>
+        <translation>System language</translation>
+    </message>
+    <message>
+        <source>Использовать язык системы.</source>
+        <translation>Use the system language.</translation>
+    </message>
+    <message>
+        <source>Русский</source>
+        <translation>Русский</translation>
+    </message>
+    <message>
+        <source>Переключить интерфейс и наименование объекта на русский язык.</source>
+        <translation>Switch the interface and the object name to Russian.</translation>
+    </message>
+    <message>
+        <source>English</source>
+        <translation>English</translation>
+    </message>
+    <message>
+        <source>Переключить интерфейс и наименование объекта на английский язык.</source>
+        <translation>Switch the interface and the object name to English.</translation>
+    </message>
+    <message>
+        <source>Выберите TOML-файл для просмотра</source>
+        <translation>Select a TOML file to view</translation>
+    </message>
+    <message>
+        <source>Текстовые файлы (*.toml)</source>
+        <translation>Text files (*.toml)</translation>
+    </message>
+    <message>
+        <source>&lt;b&gt;TomlObjectViewer&lt;/b&gt;&lt;br&gt;Версия: 0.2.0&lt;br&gt;Автор: san&lt;br&gt;&lt;br&gt;Программа для просмотра объектов, описанных в формате TOML.</source>
+        <translation>&lt;b&gt;TomlObjectViewer&lt;/b&gt;&lt;br&gt;Version: 0.2.0&lt;br&gt;Author: san&lt;br&gt;&lt;br&gt;A viewer for objects described in TOML format.</translation>
+    </message>
+    <message>
+        <source>Экспорт...</source>
+        <translation>Export...</translation>
+    </message>
+    <message>
+        <source>Экспортировать текущее состояние объекта в JSON, CSV или TOML.</source>
+        <translation>Export the current object state to JSON, CSV or TOML.</translation>
+    </message>
+    <message>
+        <source>Экспорт объекта</source>
+        <translation>Export object</translation>
+    </message>
+    <message>
+        <source>JSON (*.json);;CSV (*.csv);;TOML (*.toml)</source>
+        <translation>JSON (*.json);;CSV (*.csv);;TOML (*.toml)</translation>
+    </message>
+    <message>
+        <source>Экспорт в '%1'...</source>
+        <translation>Exporting to '%1'...</translation>
+    </message>
+    <message>
+        <source>Объект экспортирован в '%1'.</source>
+        <translation>Object exported to '%1'.</translation>
+    </message>
+    <message>
+        <source>Сервер управления: %1</source>
+        <translation>Control server: %1</translation>
+    </message>
+    <message>
+        <source>Сравнить объекты...</source>
+        <translation>Compare objects...</translation>
+    </message>
+    <message>
+        <source>Сравнить два TOML-файла объектов.</source>
+        <translation>Compare two object TOML files.</translation>
+    </message>
+    <message>
+        <source>Выберите первый TOML-файл для сравнения</source>
+        <translation>Select the first TOML file to compare</translation>
+    </message>
+    <message>
+        <source>Выберите второй TOML-файл для сравнения</source>
+        <translation>Select the second TOML file to compare</translation>
+    </message>
+    <message>
+        <source>Исходный текст</source>
+        <translation>Source</translation>
+    </message>
+    <message>
+        <source>Все параметры корректны</source>
+        <translation>All parameters are valid</translation>
+    </message>
+    <message>
+        <source>Ошибки: %1, предупреждения: %2</source>
+        <translation>Errors: %1, warnings: %2</translation>
+    </message>
+</context>
+<context>
+    <name>TreeModel</name>
+    <message>
+        <source>Объект</source>
+        <translation>Object</translation>
+    </message>
+    <message>
+        <source>Свойства объекта</source>
+        <translation>Object properties</translation>
+    </message>
+    <message>
+        <source>Параметры объекта</source>
+        <translation>Object parameters</translation>
+    </message>
+    <message>
+        <source>Параметр</source>
+        <translation>Parameter</translation>
+    </message>
+    <message>
+        <source>Идентификатор</source>
+        <translation>Id</translation>
+    </message>
+    <message>
+        <source>Тип</source>
+        <translation>Type</translation>
+    </message>
+    <message>
+        <source>Наименование объекта</source>
+        <translation>Object name</translation>
+    </message>
+    <message>
+        <source>Признак обязательности</source>
+        <translation>Required</translation>
+    </message>
+    <message>
+        <source>Значение по умолчанию</source>
+        <translation>Default value</translation>
+    </message>
+    <message>
+        <source>Возможные значения</source>
+        <translation>Possible values</translation>
+    </message>
+    <message>
+        <source>Значение</source>
+        <translation>Value</translation>
+    </message>
+    <message>
+        <source>Неизвестный тип параметра</source>
+        <translation>Unknown parameter type</translation>
+    </message>
+    <message>
+        <source>Тип значения не совпадает с типом параметра</source>
+        <translation>Value type does not match the parameter type</translation>
+    </message>
+    <message>
+        <source>Значение не входит в список возможных</source>
+        <translation>Value is not among the possible values</translation>
+    </message>
+    <message>
+        <source>Значение запрещено ограничениями</source>
+        <translation>Value is forbidden by constraints</translation>
+    </message>
+    <message>
+        <source>Тип значения по умолчанию не совпадает с типом параметра</source>
+        <translation>Default value type does not match the parameter type</translation>
+    </message>
+    <message>
+        <source>Значение по умолчанию не входит в список возможных</source>
+        <translation>Default value is not among the possible values</translation>
+    </message>
+    <message>
+        <source>Тип возможных значений не совпадает с типом параметра</source>
+        <translation>Possible values type does not match the parameter type</translation>
+    </message>
+    <message>
+        <source>Значение обязательного параметра не входит в список возможных</source>
+        <translation>Value of a required parameter is not among the possible values</translation>
+    </message>
+</context>
+<context>
+    <name>DiffWindow</name>
+    <message>
+        <source>Сравнение объектов</source>
+        <translation>Object comparison</translation>
+    </message>
+    <message>
+        <source>Загрузка...</source>
+        <translation>Loading...</translation>
+    </message>
+    <message>
+        <source>Добавлено параметров: %1, удалено: %2, изменено: %3.</source>
+        <translation>Parameters added: %1, removed: %2, changed: %3.</translation>
+    </message>
+</context>
+</TS>
@@ -9,14 +9,19 @@
 
 #include "TreeItem.h"
 
+#include <algorithm>
+
 TreeItem::TreeItem(ItemType t_type, QVariantList t_data, TreeItem *t_parent) :
-    m_type(t_type), m_itemData(std::move(t_data)), m_paramPossibleValues(), m_paramValue(),
-    m_childItems(), m_parentItem(t_parent)
+    m_type(t_type), m_itemData(std::move(t_data)), m_label(Label::None), m_labelColumn(-1),
+    m_paramId(), m_paramType(), m_paramRequired(false), m_paramPossibleValues(),
+    m_paramAllowedValues(), m_paramValue(), m_paramTypeIssues(), m_paramIssues(), m_sortKeys(),
+    m_row(0), m_childItems(), m_parentItem(t_parent)
 {}
 
 TreeItem *
 TreeItem::appendChild(std::unique_ptr<TreeItem> &&child)
 {
+        child->m_row = int(m_childItems.size());
         m_childItems.push_back(std::move(child));
         return m_childItems.back().get();
 }
@@ -27,6 +32,12 @@ TreeItem::child(int row)
         return row >= 0 && row < childCount() ? m_childItems.at(row).get() : nullptr;
 }
 
+const TreeItem *
+TreeItem::child(int row) const
+{
+        return row >= 0 && row < childCount() ? m_childItems.at(row).get() : nullptr;
+}
+
 int
 TreeItem::childCount() const
 {
@@ -51,12 +62,60 @@ TreeItem::parentItem()
         return m_parentItem;
 }
 
+const TreeItem *
+TreeItem::parentItem() const
+{
+        return m_parentItem;
+}
+
 const TreeItem::ItemType
 TreeItem::getType() const
 {
         return m_type;
 }
 
+void
+TreeItem::setParamId(const QString &id)
+{
+        if (m_type == TreeItem::ItemType::ObjectParameterEditable) {
+                m_paramId = id;
+        }
+}
+
+QString
+TreeItem::getParamId() const
+{
+        return m_paramId;
+}
+
+void
+TreeItem::setParamType(const QString &type)
+{
+        if (m_type == TreeItem::ItemType::ObjectParameterEditable) {
+                m_paramType = type;
+        }
+}
+
+QString
+TreeItem::getParamType() const
+{
+        return m_paramType;
+}
+
+void
+TreeItem::setParamRequired(bool required)
+{
+        if (m_type == TreeItem::ItemType::ObjectParameterEditable) {
+                m_paramRequired = required;
+        }
+}
+
+bool
+TreeItem::isParamRequired() const
+{
+        return m_paramRequired;
+}
+
 void
 TreeItem::setParamPossibleValues(const QStringList values)
 {
@@ -69,6 +128,24 @@ TreeItem::getParamPossibleValues() const
         return m_paramPossibleValues;
 }
 
+void
+TreeItem::setParamAllowedValues(const QStringList &values)
+{
+        m_paramAllowedValues = values;
+}
+
+QStringList
+TreeItem::getParamAllowedValues() const
+{
+        return m_paramAllowedValues;
+}
+
+bool
+TreeItem::isParamValueAllowed() const
+{
+        return m_paramAllowedValues.contains(m_paramValue);
+}
+
 void
 TreeItem::setParamValue(const QString &value)
 {
@@ -105,6 +182,30 @@ TreeItem::getParamDefaultValue() const
         }
 }
 
+void
+TreeItem::setParamTypeIssues(Issues issues)
+{
+        m_paramTypeIssues = issues;
+}
+
+TreeItem::Issues
+TreeItem::getParamTypeIssues() const
+{
+        return m_paramTypeIssues;
+}
+
+void
+TreeItem::setParamIssues(Issues issues)
+{
+        m_paramIssues = issues;
+}
+
+TreeItem::Issues
+TreeItem::getParamIssues() const
+{
+        return m_paramIssues;
+}
+
 QString
 TreeItem::getItemData() const
 {
@@ -115,20 +216,63 @@ TreeItem::getItemData() const
         return stringList.join(", ");
 }
 
+void
+TreeItem::setLabel(int column, Label label)
+{
+        m_labelColumn = column;
+        m_label       = label;
+}
+
+TreeItem::Label
+TreeItem::label() const
+{
+        return m_label;
+}
+
+int
+TreeItem::labelColumn() const
+{
+        return m_labelColumn;
+}
+
+void
+TreeItem::setSortKeys(SortKeys keys)
+{
+        m_sortKeys = std::move(keys);
+}
+
+const TreeItem::SortKeys *
+TreeItem::sortKeys() const
+{
+        return m_sortKeys ? &*m_sortKeys : nullptr;
+}
+
+void
+TreeItem::setValueSortKey(const QCollatorSortKey &key)
+{
+        if (m_sortKeys)
+                m_sortKeys->value = key;
+}
+
+void
+TreeItem::sortChildren(const std::function<bool(const TreeItem *, const TreeItem *)> &lessThan)
+{
+        std::sort(m_childItems.begin(),
+                  m_childItems.end(),
+                  [&lessThan](const auto &a, const auto &b) { return lessThan(a.get(), b.get()); });
+
+        for (size_t i = 0; i < m_childItems.size(); ++i)
+                m_childItems[i]->m_row = int(i);
+}
+
 int
 TreeItem::row() const
 {
         if (m_parentItem == nullptr)
                 return 0;
-        const auto it = std::find_if(
-            m_parentItem->m_childItems.cbegin(),
-            m_parentItem->m_childItems.cend(),
-            [this](const std::unique_ptr<TreeItem> &treeItem) { return treeItem.get() == this; });
-
-        if (it != m_parentItem->m_childItems.cend())
-                return std::distance(m_parentItem->m_childItems.cbegin(), it);
-        Q_ASSERT(false);    // should not happen
-        return -1;
+
+        Q_ASSERT(m_parentItem->m_childItems.at(m_row).get() == this);
+        return m_row;
 }
 
 bool
@@ -4,9 +4,14 @@
 #ifndef TREEITEM_H
 #define TREEITEM_H
 
+#include <QCollatorSortKey>
+#include <QFlags>
 #include <QList>
 #include <QVariant>
 
+#include <functional>
+#include <optional>
+
 class TreeItem
 {
 public:
@@ -16,36 +21,115 @@ public:
                 ObjectParameter,
                 ObjectParameterEditable
         };
+
+        // Подпись раздела или поля; текст подписи переводится моделью при отображении
+        enum class Label
+        {
+                None,
+                Object,
+                ObjectProperties,
+                ObjectParameters,
+                Parameter,
+                Id,
+                Type,
+                ObjectName,
+                Required,
+                DefaultValue,
+                PossibleValues,
+                Value
+        };
+        // Ключи сортировки узла "Параметр". Вычисляются один раз при загрузке,
+        // поэтому пересортировка сводится к сравнению готовых ключей.
+        struct SortKeys
+        {
+                int              fileOrder;
+                QCollatorSortKey id;
+                QCollatorSortKey type;
+                bool             required;
+                QCollatorSortKey value;
+        };
+
+        // Нарушения, найденные при проверке параметра (TreeModel::updateStatus())
+        enum class Issue
+        {
+                UnknownType        = 0x01,
+                ValueType          = 0x02,
+                ValueNotPossible   = 0x04,
+                ValueNotAllowed    = 0x08,
+                DefaultType        = 0x10,
+                DefaultNotPossible = 0x20,
+                PossibleValuesType = 0x40
+        };
+        Q_DECLARE_FLAGS(Issues, Issue)
+
         explicit TreeItem(ItemType t_type, QVariantList t_data, TreeItem *parentItem = nullptr);
 
         TreeItem *appendChild(std::unique_ptr<TreeItem> &&child);
 
-        TreeItem      *child(int row);
-        int            childCount() const;
-        int            columnCount() const;
-        QVariant       data(int column) const;
-        bool           setData(int column, const QVariant &value);
-        int            row() const;
-        TreeItem      *parentItem();
-        const ItemType getType() const;
-        void           setParamPossibleValues(const QStringList values);
-        QStringList    getParamPossibleValues() const;
-        void           setParamValue(const QString &value);
-        QString        getParamValue() const;
-        void           setParamDefaultValue(const QString &value);
-        QString        getParamDefaultValue() const;
-        QString        getItemData() const;
+        TreeItem       *child(int row);
+        const TreeItem *child(int row) const;
+        int             childCount() const;
+        int             columnCount() const;
+        QVariant        data(int column) const;
+        bool            setData(int column, const QVariant &value);
+        int             row() const;
+        TreeItem       *parentItem();
+        const TreeItem *parentItem() const;
+        const ItemType  getType() const;
+        void            setParamId(const QString &id);
+        QString         getParamId() const;
+        void            setParamType(const QString &type);
+        QString         getParamType() const;
+        void            setParamRequired(bool required);
+        bool            isParamRequired() const;
+        void            setParamPossibleValues(const QStringList values);
+        QStringList     getParamPossibleValues() const;
+        // Подмножество possible_values, допустимое с учётом правил [[constraints]]
+        void            setParamAllowedValues(const QStringList &values);
+        QStringList     getParamAllowedValues() const;
+        bool            isParamValueAllowed() const;
+        void            setParamValue(const QString &value);
+        QString         getParamValue() const;
+        void            setParamDefaultValue(const QString &value);
+        QString         getParamDefaultValue() const;
+        // Несовпадения типов значений с типом параметра (только Issue::*Type);
+        // известны по типам узлов TOML, поэтому запоминаются при загрузке
+        void            setParamTypeIssues(Issues issues);
+        Issues          getParamTypeIssues() const;
+        void            setParamIssues(Issues issues);
+        Issues          getParamIssues() const;
+        QString         getItemData() const;
+        void            setLabel(int column, Label label);
+        Label           label() const;
+        int             labelColumn() const;
+        void            setSortKeys(SortKeys keys);
+        const SortKeys *sortKeys() const;
+        void            setValueSortKey(const QCollatorSortKey &key);
+        void sortChildren(const std::function<bool(const TreeItem *, const TreeItem *)> &lessThan);
 
 private:
-        ItemType     m_type;
-        QVariantList m_itemData;
+        ItemType                m_type;
+        QVariantList            m_itemData;
+        Label                   m_label;
+        int                     m_labelColumn;
         // Поля для работы со значениями параметров
-        QStringList  m_paramPossibleValues;
-        QString      m_paramValue;
-        QString      m_paramDefaultValue;
+        QString                 m_paramId;
+        QString                 m_paramType;
+        bool                    m_paramRequired;
+        QStringList             m_paramPossibleValues;
+        QStringList             m_paramAllowedValues;
+        QString                 m_paramValue;
+        QString                 m_paramDefaultValue;
+        Issues                  m_paramTypeIssues;
+        Issues                  m_paramIssues;
+        std::optional<SortKeys> m_sortKeys;
+        // Номер строки в родителе, поддерживается appendChild() и sortChildren()
+        int                     m_row;
 
         std::vector<std::unique_ptr<TreeItem>> m_childItems;
         TreeItem                              *m_parentItem;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(TreeItem::Issues)
+
 #endif    // TREEITEM_H
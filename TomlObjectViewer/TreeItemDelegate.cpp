@@ -14,7 +14,7 @@ TreeItemDelegate::createEditor(QWidget *parent, const QStyleOptionViewItem &opti
         if (index.column() == 2 && item->getType() == TreeItem::ItemType::ObjectParameterEditable) {
                 auto *comboBox = new QComboBox(parent);
 
-                QStringList possibleValues = item->getParamPossibleValues();
+                QStringList possibleValues = item->getParamAllowedValues();
                 for (const auto &val : possibleValues) {
                         comboBox->addItem(val);
                 }
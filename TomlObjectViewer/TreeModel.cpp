@@ -1,24 +1,77 @@
 #include "TreeModel.h"
 #include "TreeItem.h"
+#include "BaseCache.h"
 
+#include <QApplication>
+#include <QColor>
 #include <QComboBox>
-#include <QFile>
 #include <QLocale>
 #include <QStringList>
+#include <QStyle>
 
 #include <exception>
-#include <sstream>
 #include <stdexcept>
 #include <string_view>
+#include <unordered_set>
+#include <utility>
 
 using namespace Qt::StringLiterals;
 
+namespace
+{
+
+// Ключ TOML, которым описывается поле с подписью label
+std::string_view
+sourceFieldKey(TreeItem::Label label)
+{
+        switch (label) {
+        case TreeItem::Label::Id:
+                return "id";
+        case TreeItem::Label::Type:
+                return "type";
+        case TreeItem::Label::ObjectName:
+                return "name";
+        case TreeItem::Label::Required:
+                return "required";
+        case TreeItem::Label::DefaultValue:
+                return "default_value";
+        case TreeItem::Label::PossibleValues:
+                return "possible_values";
+        case TreeItem::Label::Value:
+                return "value";
+        default:
+                return {};
+        }
+}
+
+// Значение для отображения: строки в кавычках
+QString
+nodeLiteral(const toml::node &node)
+{
+        return node.is_string() ? "\"" + ObjectSnapshot::valueText(node) + "\""
+                                : ObjectSnapshot::valueText(node);
+}
+
+// Параметры любого типа, кроме "integer", хранят строки
+bool
+hasParamType(const toml::node &node, const QString &type)
+{
+        return type == u"integer"_s ? node.is_integer() : node.is_string();
+}
+
+}    // namespace
+
 TreeModel::TreeModel(QObject *parent) :
     QAbstractItemModel(parent),
     rootItem(std::make_unique<TreeItem>(TreeItem::ItemType::ObjectProperty, QVariantList())),
-    m_tomlFilePath(), m_toml()
+    m_parametersItem(nullptr), m_objectNameItem(nullptr), m_tomlFilePath(),
+    m_language(QLocale::system()), m_statusCounts(),
+    m_snapshot(std::make_shared<const ObjectSnapshot>()), m_toml(),
+    m_collator(QLocale::system()),
+    m_sortKey(SortKey::FileOrder), m_sortOrder(Qt::AscendingOrder), m_editLocks(0)
 {
-        m_systemLanguage = QLocale::system().name().split("_").first();
+        // Числа внутри строк сравниваются по величине: 8 < 16 < 512
+        m_collator.setNumericMode(true);
 }
 
 TreeModel::~TreeModel() = default;
@@ -35,11 +88,24 @@ void
 TreeModel::clear()
 {
         beginResetModel();
+        clearData();
+        endResetModel();
+        emit statusSummaryChanged();
+}
 
+void
+TreeModel::clearData()
+{
+        m_parametersItem = nullptr;
+        m_objectNameItem = nullptr;
+        m_objectNames.clear();
+        m_parametersById.clear();
+        m_constraints.clear();
+        m_diffMarks.clear();
+        m_statusCounts.fill(0);
+        m_snapshot = std::make_shared<const ObjectSnapshot>();
         rootItem.reset();
         rootItem = std::make_unique<TreeItem>(TreeItem::ItemType::ObjectProperty, QVariantList());
-
-        endResetModel();
 }
 
 void
@@ -54,23 +120,27 @@ TreeModel::checkToml(const toml::table &parsed)
 
         // Проверка обязательных полей в [properties]
         if (!properties->contains("id") || !properties->get("id")->is<std::string>()) {
-                throw std::runtime_error("Отсутствует обязательное поле 'id' в [properties].");
+                throw ValidationError("Отсутствует обязательное поле 'id' в [properties].",
+                                      properties->source());
         }
         if (!properties->contains("type") || !properties->get("type")->is<std::string>()) {
-                throw std::runtime_error("Отсутствует обязательное поле 'type' в [properties].");
+                throw ValidationError("Отсутствует обязательное поле 'type' в [properties].",
+                                      properties->source());
         }
         if (!properties->contains("name") || !properties->get("name")->is<toml::table>() ||
             !properties->get("name")->as_table()->contains("default")) {
-                throw std::runtime_error(
-                    "Отсутствует обязательное поле 'default' в [properties.name].");
+                throw ValidationError(
+                    "Отсутствует обязательное поле 'default' в [properties.name].",
+                    properties->source());
         }
 
         // Проверка на наличие таблицы [properties.name]
         const auto &propertiesName = properties->get("name")->as_table();
         if (!propertiesName->contains("default") ||
             !propertiesName->get("default")->is<std::string>()) {
-                throw std::runtime_error(
-                    "Отсутствует обязательное поле 'default' в [properties.name].");
+                throw ValidationError(
+                    "Отсутствует обязательное поле 'default' в [properties.name].",
+                    properties->source());
         }
 
         // Проверка на существование параметров
@@ -81,94 +151,333 @@ TreeModel::checkToml(const toml::table &parsed)
         const auto &parameters = parsed["parameters"].as_array();
 
         if (parameters->empty()) {
-                throw std::runtime_error(
-                    "В таблице [parameters] должен быть хотя бы один параметр.");
+                throw ValidationError(
+                    "В таблице [parameters] должен быть хотя бы один параметр.",
+                    parameters->source());
         }
 
-        // Проверка каждого параметра
+        // Проверка каждого параметра. Идентификаторы уникальны: по ним
+        // параметры ищутся в модели, сервере управления и при сравнении.
+        std::unordered_set<std::string> paramIds;
         for (const auto &param : *parameters) {
                 const auto &paramTable = param.as_table();
 
                 // Проверка обязательных полей для параметра
                 if (!paramTable->contains("id") || !paramTable->get("id")->is<std::string>()) {
-                        throw std::runtime_error("Отсутствует обязательное поле 'id' в параметре.");
+                        throw ValidationError("Отсутствует обязательное поле 'id' в параметре.",
+                                              paramTable->source());
                 }
                 if (!paramTable->contains("type") || !paramTable->get("type")->is<std::string>()) {
-                        throw std::runtime_error(
-                            "Отсутствует обязательное поле 'type' в параметре.");
+                        throw ValidationError(
+                            "Отсутствует обязательное поле 'type' в параметре.",
+                            paramTable->source());
                 }
                 if (!paramTable->contains("required") || !paramTable->get("required")->is<bool>()) {
-                        throw std::runtime_error(
-                            "Отсутствует обязательное поле 'required' в параметре.");
+                        throw ValidationError(
+                            "Отсутствует обязательное поле 'required' в параметре.",
+                            paramTable->source());
                 }
                 if (!paramTable->contains("default_value")) {
-                        throw std::runtime_error(
-                            "Отсутствует обязательное поле 'default_value' в параметре.");
+                        throw ValidationError(
+                            "Отсутствует обязательное поле 'default_value' в параметре.",
+                            paramTable->source());
                 }
                 if (!paramTable->contains("possible_values") ||
                     !paramTable->get("possible_values")->is<toml::array>()) {
-                        throw std::runtime_error(
-                            "Отсутствует обязательное поле 'possible_values' в параметре.");
+                        throw ValidationError(
+                            "Отсутствует обязательное поле 'possible_values' в параметре.",
+                            paramTable->source());
                 }
                 if (!paramTable->contains("value")) {
-                        throw std::runtime_error(
-                            "Отсутствует обязательное поле 'value' в параметре.");
+                        throw ValidationError(
+                            "Отсутствует обязательное поле 'value' в параметре.",
+                            paramTable->source());
                 }
-        }
-}
-
-void
-TreeModel::reset(const QString &t_tomlFilePath)
-{
-        beginResetModel();
 
-        m_tomlFilePath = t_tomlFilePath;
+                const std::string paramId = paramTable->get("id")->value_or<std::string>("");
+                if (!paramIds.insert(paramId).second) {
+                        throw ValidationError("Повторяющийся идентификатор параметра '" +
+                                                  paramId + "'.",
+                                              paramTable->source());
+                }
+        }
 
-        QFile f(m_tomlFilePath);
-        if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) {
-                throw std::runtime_error("Не удалось открыть файл '" +
-                                         m_tomlFilePath.toStdString() + "'");
+        // Проверка правил [[constraints]] (необязательная таблица)
+        if (!parsed.contains("constraints"))
                 return;
+
+        if (!parsed["constraints"].is_array_of_tables()) {
+                throw ValidationError("Поле 'constraints' должно быть массивом таблиц.",
+                                      parsed["constraints"].node()->source());
         }
 
-        std::string fileContent = QString::fromUtf8(f.readAll()).toStdString();
-        f.close();
+        const auto checkClause = [&paramIds](const toml::table *constraint,
+                                             std::string_view   clause,
+                                             std::string_view   valuesKey) {
+                const std::string where = "в правиле [[constraints]], раздел '" +
+                                          std::string(clause) + "'.";
 
-        try {
-                m_toml = toml::parse(fileContent);
-        } catch (toml::parse_error &err) {
-                throw toml::parse_error(err);
-                return;
+                if (!constraint->contains(clause) || !constraint->get(clause)->is<toml::table>()) {
+                        throw ValidationError("Отсутствует обязательная таблица " + where,
+                                              constraint->source());
+                }
+                const auto &clauseTable = constraint->get(clause)->as_table();
+
+                if (!clauseTable->contains("parameter") ||
+                    !clauseTable->get("parameter")->is<std::string>()) {
+                        throw ValidationError("Отсутствует обязательное поле 'parameter' " +
+                                                  where,
+                                              clauseTable->source());
+                }
+                const std::string paramId =
+                    clauseTable->get("parameter")->value_or<std::string>("");
+                if (paramIds.count(paramId) == 0) {
+                        throw ValidationError("Неизвестный параметр '" + paramId + "' " + where,
+                                              clauseTable->source());
+                }
+
+                if (!clauseTable->contains(valuesKey) ||
+                    !clauseTable->get(valuesKey)->is<toml::array>()) {
+                        throw ValidationError("Отсутствует обязательное поле '" +
+                                                  std::string(valuesKey) + "' " + where,
+                                              clauseTable->source());
+                }
+        };
+
+        for (const auto &constraint : *parsed["constraints"].as_array()) {
+                checkClause(constraint.as_table(), "when", "values");
+                checkClause(constraint.as_table(), "then", "allowed");
         }
+}
+
+toml::table
+TreeModel::parseFile(const QString &t_tomlFilePath)
+{
+        // Базовые объекты (extends) подставляются из общего кэша
+        toml::table parsed = BaseCache::instance().resolve(t_tomlFilePath);
 
-        this->clear();
+        checkToml(parsed);
 
-        rootItem.reset(
-            new TreeItem(TreeItem::ItemType::ObjectProperty, QVariantList{ tr("Объект"), "", "" }));
+        return parsed;
+}
 
+TreeModel::LoadResult
+TreeModel::loadFile(const QString &t_tomlFilePath)
+{
         try {
-                checkToml(m_toml);
+                return { parseFile(t_tomlFilePath), QString(), toml::source_region() };
         } catch (const std::runtime_error &e) {
-                throw std::runtime_error(e);
+                return { toml::table(), loadErrorMessage(e), errorSource(e) };
+        }
+}
+
+ValidationError::ValidationError(const std::string &what, toml::source_region source) :
+    std::runtime_error(what), m_source(std::move(source))
+{
+}
+
+const toml::source_region &
+ValidationError::source() const noexcept
+{
+        return m_source;
+}
+
+QString
+TreeModel::loadErrorMessage(const std::runtime_error &error)
+{
+        if (const auto *parseError = dynamic_cast<const toml::parse_error *>(&error)) {
+                std::string what(parseError->description().begin(),
+                                 parseError->description().end());
+                return "Не удалось выполнить разбор файла TOML. Причина: '" +
+                       QString::fromStdString(what) + "'.";
         }
+        return QString::fromStdString(error.what());
+}
+
+toml::source_region
+TreeModel::errorSource(const std::runtime_error &error)
+{
+        if (const auto *parseError = dynamic_cast<const toml::parse_error *>(&error))
+                return parseError->source();
+        if (const auto *validationError = dynamic_cast<const ValidationError *>(&error))
+                return validationError->source();
+        return {};
+}
+
+void
+TreeModel::reset(const QString &t_tomlFilePath)
+{
+        reset(t_tomlFilePath, parseFile(t_tomlFilePath));
+}
+
+void
+TreeModel::reset(const QString &t_tomlFilePath, toml::table t_parsedToml)
+{
+        beginResetModel();
+
+        clearData();
+
+        m_tomlFilePath = t_tomlFilePath;
+        m_toml         = std::move(t_parsedToml);
+
+        rootItem.reset(
+            new TreeItem(TreeItem::ItemType::ObjectProperty, QVariantList{ "", "", "" }));
+        rootItem->setLabel(0, TreeItem::Label::Object);
 
         try {
                 setupModelData(rootItem.get());
-        } catch (const std::runtime_error &e) {
-                throw std::runtime_error(e);
+        } catch (...) {
+                clearData();
+                endResetModel();
+                emit statusSummaryChanged();
+                throw;
         }
 
+        sortParameterItems();
+
         endResetModel();
+        emit statusSummaryChanged();
 }
 
 QVariant
 TreeModel::data(const QModelIndex &index, int role) const
 {
-        if (!index.isValid() || role != Qt::DisplayRole)
+        if (!index.isValid())
                 return {};
 
         const auto *item = static_cast<const TreeItem *>(index.internalPointer());
-        return item->data(index.column());
+
+        if (role == Qt::EditRole && index.column() == 2 &&
+            item->getType() == TreeItem::ItemType::ObjectParameterEditable)
+                return item->getParamValue();
+
+        if (role == Qt::BackgroundRole && !m_diffMarks.isEmpty()) {
+                const auto it = m_diffMarks.constFind(item);
+                if (it == m_diffMarks.cend())
+                        return {};
+
+                switch (it.value()) {
+                case DiffMark::Added:
+                        return QColor(200, 240, 200);
+                case DiffMark::Removed:
+                        return QColor(245, 200, 200);
+                case DiffMark::Changed:
+                        return QColor(250, 235, 180);
+                }
+        }
+
+        if (role == Qt::DecorationRole || role == Qt::ToolTipRole || role == Qt::ForegroundRole) {
+                // Состояние показывается у значения и у узла самого параметра
+                const TreeItem *valueItem = nullptr;
+                if (index.column() == 2 &&
+                    item->getType() == TreeItem::ItemType::ObjectParameterEditable)
+                        valueItem = item;
+                else if (index.column() == 0 && item->label() == TreeItem::Label::Parameter &&
+                         role != Qt::ForegroundRole)
+                        valueItem = item->child(item->childCount() - 1);
+                if (valueItem == nullptr)
+                        return {};
+
+                const ParameterStatus status = statusOf(valueItem);
+                if (status == ParameterStatus::Valid)
+                        return {};
+
+                switch (role) {
+                case Qt::DecorationRole:
+                        return QApplication::style()->standardIcon(
+                            status == ParameterStatus::Error ? QStyle::SP_MessageBoxCritical
+                                                             : QStyle::SP_MessageBoxWarning);
+                case Qt::ToolTipRole:
+                        return issuesText(valueItem);
+                default:
+                        return status == ParameterStatus::Error ? QVariant(QColor(Qt::red))
+                                                                : QVariant();
+                }
+        }
+
+        if (role != Qt::DisplayRole)
+                return {};
+
+        return itemData(item, index.column());
+}
+
+QVariant
+TreeModel::itemData(const TreeItem *item, int column) const
+{
+        if (item->label() != TreeItem::Label::None && column == item->labelColumn())
+                return labelText(item->label());
+
+        if (item == m_objectNameItem && column == 2)
+                return "\"" + objectDisplayName() + "\"";
+
+        return item->data(column);
+}
+
+QString
+TreeModel::labelText(TreeItem::Label label)
+{
+        static const char *const labels[] = {
+                "",
+                QT_TR_NOOP("Объект"),
+                QT_TR_NOOP("Свойства объекта"),
+                QT_TR_NOOP("Параметры объекта"),
+                QT_TR_NOOP("Параметр"),
+                QT_TR_NOOP("Идентификатор"),
+                QT_TR_NOOP("Тип"),
+                QT_TR_NOOP("Наименование объекта"),
+                QT_TR_NOOP("Признак обязательности"),
+                QT_TR_NOOP("Значение по умолчанию"),
+                QT_TR_NOOP("Возможные значения"),
+                QT_TR_NOOP("Значение"),
+        };
+        return tr(labels[static_cast<int>(label)]);
+}
+
+QString
+TreeModel::objectDisplayName() const
+{
+        // Цепочка поиска перевода: ru_RU -> ru -> default
+        const QString     languageAndCountry = m_language.name();
+        const QStringList keys               = { languageAndCountry,
+                                                 languageAndCountry.section('_', 0, 0),
+                                                 u"default"_s };
+        for (const QString &key : keys) {
+                const auto it = m_objectNames.constFind(key);
+                if (it != m_objectNames.cend())
+                        return it.value();
+        }
+        return QString();
+}
+
+void
+TreeModel::setLanguage(const QLocale &language)
+{
+        m_language = language;
+
+        emit headerDataChanged(Qt::Horizontal, 0, columnCount() - 1);
+        emitDataChanged(rootItem.get(), QModelIndex(), { Qt::DisplayRole });
+}
+
+void
+TreeModel::emitDataChanged(TreeItem          *parentItem,
+                           const QModelIndex &parentIndex,
+                           const QList<int>  &roles)
+{
+        // Данные элементов не пересоздаются: представлению достаточно узнать,
+        // какие ячейки нужно перерисовать
+        const int childCount = parentItem->childCount();
+        if (childCount == 0)
+                return;
+
+        emit dataChanged(index(0, 0, parentIndex),
+                         index(childCount - 1, columnCount() - 1, parentIndex),
+                         roles);
+
+        for (int row = 0; row < childCount; ++row) {
+                TreeItem *childItem = parentItem->child(row);
+                if (childItem->childCount() > 0)
+                        emitDataChanged(childItem, createIndex(row, 0, childItem), roles);
+        }
 }
 
 Qt::ItemFlags
@@ -179,7 +488,8 @@ TreeModel::flags(const QModelIndex &index) const
 
         const auto *item = static_cast<const TreeItem *>(index.internalPointer());
 
-        if (index.column() == 2 && item->getType() == TreeItem::ItemType::ObjectParameterEditable) {
+        if (index.column() == 2 && item->getType() == TreeItem::ItemType::ObjectParameterEditable &&
+            !isEditLocked()) {
                 return Qt::ItemFlags(QAbstractItemModel::flags(index) | Qt::ItemIsEditable);
         }
 
@@ -189,8 +499,9 @@ TreeModel::flags(const QModelIndex &index) const
 QVariant
 TreeModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
-        return orientation == Qt::Horizontal && role == Qt::DisplayRole ? rootItem->data(section)
-                                                                        : QVariant{};
+        return orientation == Qt::Horizontal && role == Qt::DisplayRole
+                   ? itemData(rootItem.get(), section)
+                   : QVariant{};
 }
 
 QModelIndex
@@ -239,181 +550,180 @@ TreeModel::setupModelData(TreeItem *parent)
         TreeItem    *currParent = parent;
         QVariantList columnData;
 
-        columnData << tr("Свойства объекта") << "" << "";
-        currParent = currParent->appendChild(
-            std::make_unique<TreeItem>(TreeItem::ItemType::ObjectProperty, columnData, currParent));
+        // Подписи разделов и полей хранятся в элементах в виде TreeItem::Label и
+        // переводятся в data() на текущий язык
+        const auto appendItem = [&columnData](TreeItem          *itemParent,
+                                              TreeItem::ItemType type,
+                                              int                labelColumn,
+                                              TreeItem::Label    label) {
+                TreeItem *item = itemParent->appendChild(
+                    std::make_unique<TreeItem>(type, columnData, itemParent));
+                item->setLabel(labelColumn, label);
+                columnData.clear();
+                return item;
+        };
+
+        columnData << "" << "" << "";
+        currParent = appendItem(currParent,
+                                TreeItem::ItemType::ObjectProperty,
+                                0,
+                                TreeItem::Label::ObjectProperties);
 
-        columnData.clear();
-        columnData << "" << tr("Идентификатор")
+        columnData << "" << ""
                    << "\"" +
                           QString::fromStdString(
                               m_toml["properties"]["id"].value_or<std::string>("")) +
                           "\"";
-        currParent->appendChild(
-            std::make_unique<TreeItem>(TreeItem::ItemType::ObjectProperty, columnData, currParent));
+        appendItem(currParent, TreeItem::ItemType::ObjectProperty, 1, TreeItem::Label::Id);
 
-        columnData.clear();
-        columnData << "" << tr("Тип")
+        columnData << "" << ""
                    << "\"" +
                           QString::fromStdString(
                               m_toml["properties"]["type"].value_or<std::string>("")) +
                           "\"";
-        currParent->appendChild(
-            std::make_unique<TreeItem>(TreeItem::ItemType::ObjectProperty, columnData, currParent));
-
-        columnData.clear();
-        QString objectDefaultName;
-        QString objectNameL10n;
+        appendItem(currParent, TreeItem::ItemType::ObjectProperty, 1, TreeItem::Label::Type);
 
+        // Наименование объекта выбирается в data() по цепочке языков, поэтому
+        // здесь сохраняются все переводы
         auto objectNameTable = m_toml["properties"]["name"].as_table();
         for (const auto &[key, val] : *objectNameTable) {
-                QString strKey = QString::fromStdString(key.data());
-                QString strVal = QString::fromStdString(val.value<std::string>().value());
-                if (strKey == QString("default")) {
-                        objectDefaultName = strVal;
-                }
-                if (strKey == m_systemLanguage) {
-                        objectNameL10n = strVal;
-                }
-        }
-
-        QString objectName;
-        if (objectNameL10n.isEmpty()) {
-                objectName = objectDefaultName;
-        } else {
-                objectName = objectNameL10n;
+                m_objectNames.insert(QString::fromStdString(key.data()),
+                                     QString::fromStdString(val.value_or<std::string>("")));
         }
 
-        columnData << "" << tr("Наименование объекта") << "\"" + objectName + "\"";
-        currParent->appendChild(
-            std::make_unique<TreeItem>(TreeItem::ItemType::ObjectProperty, columnData, currParent));
+        columnData << "" << "" << "";
+        m_objectNameItem = appendItem(currParent,
+                                      TreeItem::ItemType::ObjectProperty,
+                                      1,
+                                      TreeItem::Label::ObjectName);
 
         currParent = rootItem.get();
 
-        columnData.clear();
-        columnData << tr("Параметры объекта") << "" << "";
-        currParent =
-            currParent->appendChild(std::make_unique<TreeItem>(TreeItem::ItemType::ObjectParameter,
-                                                               columnData,
-                                                               currParent));
-
-        auto objectParams = m_toml["parameters"].as_array();
+        columnData << "" << "" << "";
+        currParent = appendItem(currParent,
+                                TreeItem::ItemType::ObjectParameter,
+                                0,
+                                TreeItem::Label::ObjectParameters);
+        m_parametersItem = currParent;
+
+        int                              fileOrder    = 0;
+        auto                             objectParams = m_toml["parameters"].as_array();
+        QList<ObjectSnapshot::Parameter> snapshotParameters;
+        snapshotParameters.reserve(objectParams->size());
         for (const auto &param : *objectParams) {
-                columnData.clear();
-                columnData << tr("Параметр") << "" << "";
-                auto parent = currParent->appendChild(
-                    std::make_unique<TreeItem>(TreeItem::ItemType::ObjectParameter,
-                                               columnData,
-                                               currParent));
+                columnData << "" << "" << "";
+                auto parent = appendItem(currParent,
+                                         TreeItem::ItemType::ObjectParameter,
+                                         0,
+                                         TreeItem::Label::Parameter);
 
                 const toml::table paramTable = *param.as_table();
 
-                columnData.clear();
-                columnData << "" << tr("Идентификатор")
-                           << "\"" +
-                                  QString::fromStdString(
-                                      paramTable["id"].value_or<std::string>("")) +
-                                  "\"";
-                parent->appendChild(std::make_unique<TreeItem>(TreeItem::ItemType::ObjectParameter,
-                                                               columnData,
-                                                               parent));
+                QString paramId =
+                    QString::fromStdString(paramTable["id"].value_or<std::string>(""));
+                columnData << "" << "" << "\"" + paramId + "\"";
+                appendItem(parent, TreeItem::ItemType::ObjectParameter, 1, TreeItem::Label::Id);
 
-                columnData.clear();
                 QString paramType =
                     QString::fromStdString(paramTable["type"].value_or<std::string>(""));
-                columnData << "" << tr("Тип") << paramType;
-                parent->appendChild(std::make_unique<TreeItem>(TreeItem::ItemType::ObjectParameter,
-                                                               columnData,
-                                                               parent));
-
-                bool paramTypeFlag;
-                if (paramType == "integer") {
-                        paramTypeFlag = false;
-                } else {
-                        paramTypeFlag = true;
+                columnData << "" << "" << paramType;
+                appendItem(parent, TreeItem::ItemType::ObjectParameter, 1, TreeItem::Label::Type);
+
+                bool paramRequired = paramTable["required"].value<bool>().value();
+                columnData << "" << "" << QString(paramRequired ? "true" : "false");
+                appendItem(parent,
+                           TreeItem::ItemType::ObjectParameter,
+                           1,
+                           TreeItem::Label::Required);
+
+                // Значения показываются так, как записаны в файле; несовпадение
+                // их типа с типом параметра отражается в состоянии параметра
+                TreeItem::Issues typeIssues;
+
+                const toml::node &defaultNode          = *paramTable.get("default_value");
+                const QString     strParamDefaultValue = ObjectSnapshot::valueText(defaultNode);
+                typeIssues.setFlag(TreeItem::Issue::DefaultType,
+                                   !hasParamType(defaultNode, paramType));
+                columnData << "" << "" << nodeLiteral(defaultNode);
+                appendItem(parent,
+                           TreeItem::ItemType::ObjectParameter,
+                           1,
+                           TreeItem::Label::DefaultValue);
+
+                auto        paramPossibleValues = paramTable["possible_values"].as_array();
+                QStringList strParamPossibleValues;
+                QStringList possibleLiterals;
+                for (const toml::node &possibleValue : *paramPossibleValues) {
+                        strParamPossibleValues.append(ObjectSnapshot::valueText(possibleValue));
+                        possibleLiterals.append(nodeLiteral(possibleValue));
+                        if (!hasParamType(possibleValue, paramType))
+                                typeIssues |= TreeItem::Issue::PossibleValuesType;
                 }
-
-                columnData.clear();
-                columnData << "" << tr("Признак обязательности")
-                           << QString(paramTable["required"].value<bool>().value() ? "true"
-                                                                                   : "false");
-                parent->appendChild(std::make_unique<TreeItem>(TreeItem::ItemType::ObjectParameter,
-                                                               columnData,
-                                                               parent));
-
-                columnData.clear();
-                QString strParamDefaultValue;
-                if (!paramTypeFlag) {
-                        // integer
-                        strParamDefaultValue =
-                            QString::number(paramTable["default_value"].value<int>().value());
-                        columnData << "" << tr("Значение по умолчанию") << strParamDefaultValue;
-                } else {
-                        // string
-                        strParamDefaultValue = QString::fromStdString(
-                            paramTable["default_value"].value<std::string>().value());
-                        columnData << "" << tr("Значение по умолчанию")
-                                   << "\"" + strParamDefaultValue + "\"";
-                }
-                parent->appendChild(std::make_unique<TreeItem>(TreeItem::ItemType::ObjectParameter,
-                                                               columnData,
-                                                               parent));
-
-                columnData.clear();
-                auto               paramPossibleValues = paramTable["possible_values"].as_array();
-                std::ostringstream oss;
-                QStringList        strParamPossibleValues;
-                QString            strVal;
-                oss << "[ ";
-                for (size_t i = 0; i < paramPossibleValues->size(); ++i) {
-                        if (!paramTypeFlag) {
-                                // integer
-                                auto val = (*paramPossibleValues)[i].value<int>();
-                                strVal   = QString::number(*val);
-                                oss << *val;
-                        } else {
-                                // string
-                                auto val = (*paramPossibleValues)[i].value<std::string>();
-                                strVal   = QString::fromStdString(*val);
-                                oss << "\"" << *val << "\"";
-                        }
-                        if (i < paramPossibleValues->size() - 1) {
-                                oss << ", ";
-                        }
-                        strParamPossibleValues.append(strVal);
-                }
-                oss << " ]";
-                std::string result = oss.str();
-                columnData << "" << tr("Возможные значения") << QString::fromStdString(result);
-                parent->appendChild(std::make_unique<TreeItem>(TreeItem::ItemType::ObjectParameter,
-                                                               columnData,
-                                                               parent));
-
-                columnData.clear();
-                QString strParamVal;
-                if (!paramTypeFlag) {
-                        // integer
-                        strParamVal = QString::number(paramTable["value"].value<int>().value());
-                        columnData << "" << tr("Значение") << strParamVal;
-                } else {
-                        // string
-                        strParamVal = QString::fromStdString(
-                            paramTable["value"].value<std::string>().value());
-                        columnData << "" << tr("Значение") << "\"" + strParamVal + "\"";
-                }
-                TreeItem *t = parent->appendChild(
-                    std::make_unique<TreeItem>(TreeItem::ItemType::ObjectParameterEditable,
-                                               columnData,
-                                               parent));
+                columnData << "" << "" << "[ " + possibleLiterals.join(", ") + " ]";
+                appendItem(parent,
+                           TreeItem::ItemType::ObjectParameter,
+                           1,
+                           TreeItem::Label::PossibleValues);
+
+                const toml::node &valueNode   = *paramTable.get("value");
+                const QString     strParamVal = ObjectSnapshot::valueText(valueNode);
+                typeIssues.setFlag(TreeItem::Issue::ValueType, !hasParamType(valueNode, paramType));
+                columnData << "" << "" << nodeLiteral(valueNode);
+                TreeItem *t = appendItem(parent,
+                                         TreeItem::ItemType::ObjectParameterEditable,
+                                         1,
+                                         TreeItem::Label::Value);
+                t->setParamId(paramId);
+                t->setParamType(paramType);
+                t->setParamRequired(paramRequired);
+                t->setParamDefaultValue(strParamDefaultValue);
                 t->setParamPossibleValues(strParamPossibleValues);
+                t->setParamAllowedValues(strParamPossibleValues);
                 t->setParamValue(strParamVal);
+                t->setParamTypeIssues(typeIssues);
+                m_parametersById.insert(paramId, t);
+                snapshotParameters.append({ paramId,
+                                            paramType,
+                                            paramRequired,
+                                            strParamDefaultValue,
+                                            strParamPossibleValues,
+                                            strParamVal });
+
+                parent->setSortKeys({ fileOrder++,
+                                      m_collator.sortKey(paramId),
+                                      m_collator.sortKey(paramType),
+                                      paramRequired,
+                                      m_collator.sortKey(strParamVal) });
         }
+
+        // Правила компилируются в граф зависимостей один раз при загрузке
+        const toml::array *constraints = m_toml["constraints"].as_array();
+        if (constraints != nullptr)
+                m_constraints.compile(*constraints);
+
+        // Первичная проверка; дальше состояние пересчитывается только для
+        // изменившихся параметров. Модель ещё сбрасывается (reset()), поэтому
+        // dataChanged здесь не отправляется.
+        for (int row = 0; row < m_parametersItem->childCount(); ++row) {
+                TreeItem *parameterNode = m_parametersItem->child(row);
+                TreeItem *item          = parameterNode->child(parameterNode->childCount() - 1);
+                if (constraints != nullptr)
+                        item->setParamAllowedValues(allowedValues(item));
+                item->setParamIssues(computeIssues(item));
+                ++m_statusCounts[static_cast<int>(statusOf(item))];
+        }
+
+        m_snapshot = ObjectSnapshot::create(objectId(),
+                                            objectType(),
+                                            m_objectNames,
+                                            snapshotParameters,
+                                            m_constraints);
 }
 
 bool
 TreeModel::setData(const QModelIndex &index, const QVariant &value, int role)
 {
-        if (role == Qt::EditRole) {
+        if (role == Qt::EditRole && !isEditLocked()) {
                 auto *item = static_cast<TreeItem *>(index.internalPointer());
 
                 if (index.column() == 2 &&
@@ -422,12 +732,16 @@ TreeModel::setData(const QModelIndex &index, const QVariant &value, int role)
 
                         bool isValidValue = false;
 
-                        if (item->getParamPossibleValues().contains(newValue)) {
+                        if (item->getParamAllowedValues().contains(newValue)) {
                                 isValidValue = true;
                         }
 
                         if (isValidValue) {
-                                item->setData(index.column(), newValue);
+                                const auto statusCounts = m_statusCounts;
+                                applyParameterValue(item, newValue);
+                                updateDependents(item->getParamId());
+                                if (m_statusCounts != statusCounts)
+                                        emit statusSummaryChanged();
                                 return true;
                         }
                 }
@@ -435,4 +749,429 @@ TreeModel::setData(const QModelIndex &index, const QVariant &value, int role)
         return false;
 }
 
+bool
+TreeModel::setParameterValues(const QList<std::pair<QString, QString>> &values, QString *error)
+{
+        if (isEditLocked()) {
+                *error = "Объект временно недоступен для изменения.";
+                return false;
+        }
+
+        // Значения проверяются так, как если бы все они уже были применены:
+        // пакет может одновременно менять параметр и зависящие от него
+        QHash<QString, QString> newValues;
+        newValues.reserve(values.size());
+        for (const auto &[id, value] : values) {
+                if (!m_parametersById.contains(id)) {
+                        *error = "Параметр '" + id + "' не найден.";
+                        return false;
+                }
+                newValues.insert(id, value);
+        }
+
+        const auto valueOf = [this, &newValues](const QString &id) {
+                const auto it = newValues.constFind(id);
+                return it != newValues.cend() ? it.value() : parameterValue(id);
+        };
+        for (const auto &[id, value] : values) {
+                const TreeItem *item = m_parametersById.value(id);
+                if (!m_constraints.allowedValues(id, item->getParamPossibleValues(), valueOf)
+                         .contains(value)) {
+                        *error = "Недопустимое значение '" + value + "' параметра '" + id + "'.";
+                        return false;
+                }
+        }
+
+        const auto statusCounts = m_statusCounts;
+        for (const auto &[id, value] : values)
+                applyParameterValue(m_parametersById.value(id), value);
+        for (const auto &[id, value] : values)
+                updateDependents(id);
+        if (m_statusCounts != statusCounts)
+                emit statusSummaryChanged();
+
+        return true;
+}
+
+void
+TreeModel::applyParameterValue(TreeItem *item, const QString &newValue)
+{
+        item->setParamValue(newValue);
+        item->setData(2, item->getParamType() == "integer" ? newValue : "\"" + newValue + "\"");
+        item->parentItem()->setValueSortKey(m_collator.sortKey(newValue));
+        m_snapshot = m_snapshot->withValue(item->parentItem()->sortKeys()->fileOrder, newValue);
+
+        // Тип введённого значения определяется по тексту: в файле оно
+        // сохраняется без кавычек только у параметров типа "integer"
+        bool isInteger = true;
+        if (item->getParamType() == u"integer"_s)
+                newValue.toLongLong(&isInteger);
+        TreeItem::Issues typeIssues = item->getParamTypeIssues();
+        typeIssues.setFlag(TreeItem::Issue::ValueType, !isInteger);
+        item->setParamTypeIssues(typeIssues);
+
+        const QModelIndex index = createIndex(item->row(), 2, item);
+        emit dataChanged(index, index, { Qt::DisplayRole });
+        updateStatus(item);
+        emit parameterValueChanged(item->getParamId(), newValue);
+}
+
+QString
+TreeModel::parameterValue(const QString &id) const
+{
+        const TreeItem *item = m_parametersById.value(id, nullptr);
+        return item != nullptr ? item->getParamValue() : QString();
+}
+
+void
+TreeModel::updateAllowedValues(TreeItem *item)
+{
+        const QStringList allowed = allowedValues(item);
+        if (allowed == item->getParamAllowedValues())
+                return;
+
+        item->setParamAllowedValues(allowed);
+        updateStatus(item);
+}
+
+QStringList
+TreeModel::allowedValues(const TreeItem *item) const
+{
+        return m_constraints.allowedValues(
+            item->getParamId(),
+            item->getParamPossibleValues(),
+            [this](const QString &id) { return parameterValue(id); });
+}
+
+TreeItem::Issues
+TreeModel::computeIssues(const TreeItem *item)
+{
+        using Issue = TreeItem::Issue;
+
+        const QStringList possible = item->getParamPossibleValues();
+        const QString     type     = item->getParamType();
+
+        TreeItem::Issues issues = item->getParamTypeIssues();
+        issues.setFlag(Issue::UnknownType, type != u"integer"_s && type != u"string"_s);
+        if (!possible.contains(item->getParamValue()))
+                issues |= Issue::ValueNotPossible;
+        else if (!item->isParamValueAllowed())
+                issues |= Issue::ValueNotAllowed;
+        issues.setFlag(Issue::DefaultNotPossible, !possible.contains(item->getParamDefaultValue()));
+        return issues;
+}
+
+void
+TreeModel::updateStatus(TreeItem *item)
+{
+        const TreeItem::Issues issues = computeIssues(item);
+        if (issues == item->getParamIssues())
+                return;
+
+        --m_statusCounts[static_cast<int>(statusOf(item))];
+        item->setParamIssues(issues);
+        ++m_statusCounts[static_cast<int>(statusOf(item))];
+
+        const QModelIndex valueIndex = createIndex(item->row(), 2, item);
+        emit dataChanged(valueIndex,
+                         valueIndex,
+                         { Qt::DecorationRole, Qt::ToolTipRole, Qt::ForegroundRole });
+
+        TreeItem         *parameterNode = item->parentItem();
+        const QModelIndex nodeIndex     = createIndex(parameterNode->row(), 0, parameterNode);
+        emit dataChanged(nodeIndex, nodeIndex, { Qt::DecorationRole, Qt::ToolTipRole });
+}
+
+TreeModel::ParameterStatus
+TreeModel::statusOf(const TreeItem *item)
+{
+        using Issue = TreeItem::Issue;
+
+        const TreeItem::Issues issues = item->getParamIssues();
+
+        // Значение, которое нельзя сохранить или применить, - ошибка; для
+        // необязательного параметра значение вне possible_values допускается
+        TreeItem::Issues errors = Issue::UnknownType | Issue::ValueType | Issue::ValueNotAllowed;
+        if (item->isParamRequired())
+                errors |= Issue::ValueNotPossible;
+
+        if ((issues & errors).toInt() != 0)
+                return ParameterStatus::Error;
+        if (issues.toInt() != 0)
+                return ParameterStatus::Warning;
+        return ParameterStatus::Valid;
+}
+
+QString
+TreeModel::issuesText(const TreeItem *item)
+{
+        using Issue = TreeItem::Issue;
+
+        static const std::pair<Issue, const char *> reasons[] = {
+                { Issue::UnknownType, QT_TR_NOOP("Неизвестный тип параметра") },
+                { Issue::ValueType, QT_TR_NOOP("Тип значения не совпадает с типом параметра") },
+                { Issue::ValueNotPossible, QT_TR_NOOP("Значение не входит в список возможных") },
+                { Issue::ValueNotAllowed, QT_TR_NOOP("Значение запрещено ограничениями") },
+                { Issue::DefaultType,
+                  QT_TR_NOOP("Тип значения по умолчанию не совпадает с типом параметра") },
+                { Issue::DefaultNotPossible,
+                  QT_TR_NOOP("Значение по умолчанию не входит в список возможных") },
+                { Issue::PossibleValuesType,
+                  QT_TR_NOOP("Тип возможных значений не совпадает с типом параметра") },
+        };
+
+        const TreeItem::Issues issues = item->getParamIssues();
+
+        QStringList lines;
+        for (const auto &[issue, reason] : reasons) {
+                if (!issues.testFlag(issue))
+                        continue;
+                if (issue == Issue::ValueNotPossible && item->isParamRequired())
+                        lines.append(tr("Значение обязательного параметра не входит в список "
+                                        "возможных"));
+                else
+                        lines.append(tr(reason));
+        }
+        return lines.join(u'\n');
+}
+
+int
+TreeModel::statusCount(ParameterStatus status) const
+{
+        return m_statusCounts[static_cast<int>(status)];
+}
+
+void
+TreeModel::updateDependents(const QString &id)
+{
+        // Пересчитываются только параметры, на которые ссылаются правила с
+        // условием по параметру id
+        const QStringList dependents = m_constraints.dependents(id);
+        for (const QString &dependentId : dependents) {
+                if (TreeItem *item = m_parametersById.value(dependentId, nullptr))
+                        updateAllowedValues(item);
+        }
+}
+
+QString
+TreeModel::objectId() const
+{
+        return QString::fromStdString(m_toml["properties"]["id"].value_or<std::string>(""));
+}
+
+QString
+TreeModel::objectType() const
+{
+        return QString::fromStdString(m_toml["properties"]["type"].value_or<std::string>(""));
+}
+
+QHash<QString, QString>
+TreeModel::objectNames() const
+{
+        return m_objectNames;
+}
+
+int
+TreeModel::parameterCount() const
+{
+        return m_parametersItem != nullptr ? m_parametersItem->childCount() : 0;
+}
+
+const TreeItem *
+TreeModel::parameterItem(int row) const
+{
+        if (m_parametersItem == nullptr)
+                return nullptr;
+
+        const TreeItem *parameterNode = std::as_const(*m_parametersItem).child(row);
+        if (parameterNode == nullptr)
+                return nullptr;
+
+        // Элемент "Значение" всегда последний среди полей параметра
+        return parameterNode->child(parameterNode->childCount() - 1);
+}
+
+QModelIndex
+TreeModel::parameterValueIndex(const QString &id) const
+{
+        TreeItem *item = m_parametersById.value(id, nullptr);
+        if (item == nullptr)
+                return {};
+
+        return createIndex(item->row(), 2, item);
+}
+
+QString
+TreeModel::parameterId(const QModelIndex &index) const
+{
+        if (!index.isValid())
+                return QString();
+
+        const auto *item = static_cast<const TreeItem *>(index.internalPointer());
+        while (item != nullptr && item->label() != TreeItem::Label::Parameter)
+                item = item->parentItem();
+        if (item == nullptr)
+                return QString();
+
+        return item->child(item->childCount() - 1)->getParamId();
+}
+
+const TreeItem *
+TreeModel::propertyItem(TreeItem::Label label) const
+{
+        if (m_objectNameItem == nullptr)
+                return nullptr;
+
+        const TreeItem *propertiesItem = std::as_const(*m_objectNameItem).parentItem();
+        for (int row = 0; row < propertiesItem->childCount(); ++row) {
+                const TreeItem *item = propertiesItem->child(row);
+                if (item->label() == label)
+                        return item;
+        }
+        return nullptr;
+}
+
+toml::source_region
+TreeModel::sourceRegion(const QModelIndex &index) const
+{
+        if (!index.isValid())
+                return {};
+
+        const auto *item = static_cast<const TreeItem *>(index.internalPointer());
+
+        const TreeItem *parameterNode = item;
+        while (parameterNode != nullptr && parameterNode->label() != TreeItem::Label::Parameter)
+                parameterNode = parameterNode->parentItem();
+
+        // Порядок параметра в файле совпадает с его индексом в [[parameters]],
+        // поэтому узел находится без поиска
+        const toml::node *node = nullptr;
+        if (parameterNode != nullptr)
+                node = m_toml["parameters"][parameterNode->sortKeys()->fileOrder].node();
+        else if (item->label() == TreeItem::Label::ObjectParameters)
+                node = m_toml["parameters"].node();
+        else
+                node = m_toml["properties"].node();
+        if (node == nullptr)
+                return {};
+
+        const std::string_view key = sourceFieldKey(item->label());
+        if (const toml::table *table = node->as_table(); table != nullptr && !key.empty()) {
+                const toml::node *field = table->get(key);
+                // У значений из дискового кэша базовых объектов нет места в тексте
+                if (field != nullptr && field->source().begin.line != 0)
+                        return field->source();
+        }
+        return node->source();
+}
+
+void
+TreeModel::setDiffMarks(QHash<const TreeItem *, DiffMark> marks)
+{
+        m_diffMarks = std::move(marks);
+
+        // Отметки затрагивают произвольные элементы, поэтому перерисовывается всё
+        emitDataChanged(rootItem.get(), QModelIndex(), { Qt::BackgroundRole });
+}
+
+std::shared_ptr<const ObjectSnapshot>
+TreeModel::snapshot() const
+{
+        return m_snapshot;
+}
+
+void
+TreeModel::lockEdits()
+{
+        ++m_editLocks;
+}
+
+void
+TreeModel::unlockEdits()
+{
+        Q_ASSERT(m_editLocks > 0);
+        --m_editLocks;
+}
+
+bool
+TreeModel::isEditLocked() const
+{
+        return m_editLocks > 0;
+}
+
+void
+TreeModel::sortParameters(SortKey key, Qt::SortOrder order)
+{
+        m_sortKey   = key;
+        m_sortOrder = order;
+
+        if (m_parametersItem == nullptr)
+                return;
+
+        const QPersistentModelIndex parametersIndex =
+            createIndex(m_parametersItem->row(), 0, m_parametersItem);
+        emit layoutAboutToBeChanged({ parametersIndex }, QAbstractItemModel::VerticalSortHint);
+
+        const QModelIndexList oldIndexes = persistentIndexList();
+
+        sortParameterItems();
+
+        // Элементы при сортировке не пересоздаются, поэтому достаточно пересчитать
+        // номера строк тех же элементов
+        QModelIndexList newIndexes;
+        newIndexes.reserve(oldIndexes.size());
+        for (const QModelIndex &oldIndex : oldIndexes) {
+                auto *item = static_cast<TreeItem *>(oldIndex.internalPointer());
+                newIndexes << createIndex(item->row(), oldIndex.column(), item);
+        }
+        changePersistentIndexList(oldIndexes, newIndexes);
+
+        emit layoutChanged({ parametersIndex }, QAbstractItemModel::VerticalSortHint);
+}
+
+void
+TreeModel::sortParameterItems()
+{
+        if (m_parametersItem == nullptr)
+                return;
+
+        const SortKey       key   = m_sortKey;
+        const Qt::SortOrder order = m_sortOrder;
+
+        // Сравниваются только заранее вычисленные ключи, без повторного
+        // обращения к правилам локали
+        m_parametersItem->sortChildren([key, order](const TreeItem *a, const TreeItem *b) {
+                const TreeItem::SortKeys *lhs = a->sortKeys();
+                const TreeItem::SortKeys *rhs = b->sortKeys();
+
+                int cmp = 0;
+                switch (key) {
+                case SortKey::FileOrder:
+                        break;
+                case SortKey::Id:
+                        cmp = lhs->id.compare(rhs->id);
+                        break;
+                case SortKey::Type:
+                        cmp = lhs->type.compare(rhs->type);
+                        break;
+                case SortKey::Required:
+                        cmp = int(lhs->required) - int(rhs->required);
+                        break;
+                case SortKey::Value:
+                        cmp = lhs->value.compare(rhs->value);
+                        break;
+                }
+                if (cmp == 0)
+                        cmp = lhs->fileOrder - rhs->fileOrder;
+
+                return order == Qt::AscendingOrder ? cmp < 0 : cmp > 0;
+        });
+
+        QList<int> displayOrder;
+        displayOrder.reserve(m_parametersItem->childCount());
+        for (int row = 0; row < m_parametersItem->childCount(); ++row)
+                displayOrder << m_parametersItem->child(row)->sortKeys()->fileOrder;
+        m_snapshot = m_snapshot->withDisplayOrder(std::move(displayOrder));
+}
+
 
@@ -5,12 +5,34 @@
 #define TREEMODEL_H
 
 #include <QAbstractItemModel>
+#include <QCollator>
+#include <QHash>
+#include <QLocale>
 #include <QModelIndex>
 #include <QVariant>
 
 #include <toml++/toml.h>
 
-class TreeItem;
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "ConstraintGraph.h"
+#include "ObjectSnapshot.h"
+#include "TreeItem.h"
+
+// Ошибка проверки описания объекта (checkToml()) с местом в исходном тексте
+class ValidationError : public std::runtime_error
+{
+public:
+        ValidationError(const std::string &what, toml::source_region source);
+
+        const toml::source_region &source() const noexcept;
+
+private:
+        toml::source_region m_source;
+};
 
 class TreeModel : public QAbstractItemModel
 {
@@ -19,9 +41,54 @@ class TreeModel : public QAbstractItemModel
 public:
         Q_DISABLE_COPY_MOVE(TreeModel)
 
+        // Отметка элемента при сравнении двух объектов (см. DiffWindow)
+        enum class DiffMark
+        {
+                Added,
+                Removed,
+                Changed
+        };
+
+        // Поле, по которому упорядочиваются параметры объекта
+        enum class SortKey
+        {
+                FileOrder,
+                Id,
+                Type,
+                Required,
+                Value
+        };
+
+        // Состояние параметра по результатам проверки (см. TreeItem::Issue)
+        enum class ParameterStatus
+        {
+                Valid,
+                Warning,
+                Error
+        };
+
         explicit TreeModel(QObject *parent = nullptr);
         ~TreeModel() override;
 
+        // Результат loadFile(): разобранный объект или текст и место ошибки
+        struct LoadResult
+        {
+                toml::table         parsed;
+                QString             error;
+                toml::source_region errorSource;
+        };
+
+        // Чтение, разбор и проверка файла объекта. Не обращается к модели,
+        // поэтому может выполняться вне потока GUI; результат передаётся в reset().
+        static toml::table parseFile(const QString &filePath);
+        // То же без исключений, для QtConcurrent::run()
+        static LoadResult  loadFile(const QString &filePath);
+        static void        checkToml(const toml::table &parsedToml);
+        // Текст ошибки parseFile()/reset() для показа пользователю
+        static QString     loadErrorMessage(const std::runtime_error &error);
+        // Место ошибки в исходном тексте (begin.line == 0, если оно неизвестно)
+        static toml::source_region errorSource(const std::runtime_error &error);
+
         QVariant      data(const QModelIndex &index, int role) const override;
         Qt::ItemFlags flags(const QModelIndex &index) const override;
         QVariant      headerData(int section, Qt::Orientation orientation,
@@ -31,18 +98,105 @@ public:
         int           rowCount(const QModelIndex &parent = {}) const override;
         int           columnCount(const QModelIndex &parent = {}) const override;
         void          clear();
-        void          checkToml(const toml::table &parsedToml);
         void          reset(const QString &);
+        void          reset(const QString &, toml::table parsedToml);
         bool          setData(const QModelIndex &index, const QVariant &value, int role) override;
+        void          sortParameters(SortKey key, Qt::SortOrder order = Qt::AscendingOrder);
+        void          setLanguage(const QLocale &language);
+
+        // Доступ к данным объекта для чтения (экспорт и т.п.). Параметры
+        // перечисляются в текущем порядке отображения; parameterItem()
+        // возвращает редактируемый элемент "Значение" параметра.
+        QString                 objectId() const;
+        QString                 objectType() const;
+        QHash<QString, QString> objectNames() const;
+        int                     parameterCount() const;
+        const TreeItem         *parameterItem(int row) const;
+        // Поиск параметра по идентификатору за O(1); индекс указывает на
+        // редактируемую ячейку значения
+        QModelIndex             parameterValueIndex(const QString &id) const;
+        // Идентификатор параметра, которому принадлежит index (пустой, если
+        // index не относится к параметру)
+        QString                 parameterId(const QModelIndex &index) const;
+        // Элемент раздела "Свойства объекта" с подписью label
+        const TreeItem         *propertyItem(TreeItem::Label label) const;
+        // Место в исходном тексте, где описан элемент index: поле параметра
+        // или свойства, иначе сам параметр или раздел. Для унаследованных
+        // элементов путь указывает на файл базового объекта.
+        toml::source_region     sourceRegion(const QModelIndex &index) const;
+
+        // Пакетная установка значений по id. Допустимость проверяется для всего
+        // пакета сразу (с учётом [[constraints]]); при ошибке ничего не меняется.
+        bool setParameterValues(const QList<std::pair<QString, QString>> &values,
+                                QString                                  *error);
+        QString parameterValue(const QString &id) const;
+        // Число параметров в состоянии status; поддерживается при каждом
+        // изменении, а не пересчитывается по всему объекту
+        int     statusCount(ParameterStatus status) const;
+
+        // Подсветка различий: отмеченные элементы получают фон в Qt::BackgroundRole
+        void setDiffMarks(QHash<const TreeItem *, DiffMark> marks);
+
+        // Текущее состояние объекта для чтения вне потока GUI: O(1), без
+        // копирования данных. Вызывается только в потоке GUI.
+        std::shared_ptr<const ObjectSnapshot> snapshot() const;
+
+        // Пока блокировка установлена, значения параметров не редактируются
+        // (например, в панелях сравнения)
+        void lockEdits();
+        void unlockEdits();
+        bool isEditLocked() const;
+
+signals:
+        // Значение параметра изменено через setData()
+        void parameterValueChanged(const QString &id, const QString &value);
+        // Изменилось число параметров в каком-либо из состояний (statusCount())
+        void statusSummaryChanged();
 
 private:
-        void setupModelData(TreeItem *parent);
+        void           clearData();
+        void           setupModelData(TreeItem *parent);
+        void           sortParameterItems();
+        void           applyParameterValue(TreeItem *item, const QString &newValue);
+        QStringList    allowedValues(const TreeItem *item) const;
+        // Пересчёт при правке значений: изменения сообщаются через dataChanged.
+        // При загрузке (setupModelData()) используются allowedValues() и
+        // computeIssues() без сигналов.
+        void           updateAllowedValues(TreeItem *item);
+        void           updateDependents(const QString &id);
+        // Перепроверка одного параметра по его элементу "Значение"
+        void           updateStatus(TreeItem *item);
+        QVariant       itemData(const TreeItem *item, int column) const;
+        QString        objectDisplayName() const;
+        void           emitDataChanged(TreeItem          *parentItem,
+                                       const QModelIndex &parentIndex,
+                                       const QList<int>  &roles);
+        static QString          labelText(TreeItem::Label label);
+        static TreeItem::Issues computeIssues(const TreeItem *item);
+        static ParameterStatus  statusOf(const TreeItem *item);
+        // Причины состояния параметра для подсказки, по одной на строку
+        static QString          issuesText(const TreeItem *item);
 
         std::unique_ptr<TreeItem> rootItem;
+        TreeItem                 *m_parametersItem;
+        TreeItem                 *m_objectNameItem;
 
-        QString     m_tomlFilePath;
-        QString     m_systemLanguage;
-        toml::table m_toml;
+        QString                               m_tomlFilePath;
+        QLocale                               m_language;
+        QHash<QString, QString>               m_objectNames;
+        // Элементы "Значение" параметров по идентификатору параметра
+        QHash<QString, TreeItem *>            m_parametersById;
+        QHash<const TreeItem *, DiffMark>     m_diffMarks;
+        ConstraintGraph                       m_constraints;
+        // Число параметров в каждом состоянии, индекс - ParameterStatus
+        std::array<int, 3>                    m_statusCounts;
+        // Обновляется при каждом изменении значения и порядка параметров
+        std::shared_ptr<const ObjectSnapshot> m_snapshot;
+        toml::table                           m_toml;
+        QCollator                             m_collator;
+        SortKey                               m_sortKey;
+        Qt::SortOrder                         m_sortOrder;
+        int                                   m_editLocks;
 };
 
 #endif    // TREEMODEL_H
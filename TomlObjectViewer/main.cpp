@@ -1,30 +1,186 @@
 #include "MainWindow.h"
+#include "ObjectExporter.h"
+#include "ObjectSnapshot.h"
+#include "StartupMeter.h"
+#include "TreeModel.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
 #include <QLocale>
+#include <QTextStream>
 #include <QTranslator>
+#include <QtConcurrent>
+
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+using namespace Qt::StringLiterals;
+
+// Файл перевода для locale среди встроенных в ресурсы (см. qt_add_resources
+// в CMakeLists.txt). Список файлов читается один раз, поэтому перебор
+// uiLanguages() не обращается к ресурсам для каждого варианта имени, как
+// QTranslator::load(QLocale, ...).
+static QString
+translationFile(const QLocale &locale)
+{
+        static const QStringList available =
+            QDir(u":/i18n"_s).entryList({ u"TomlObjectViewer_*.qm"_s }, QDir::Files);
+
+        for (QString language : locale.uiLanguages()) {
+                language.replace('-', '_');
+
+                // Исходные строки интерфейса русские, перевод для них не нужен
+                const QString languageCode = language.section('_', 0, 0);
+                if (languageCode == u"ru"_s)
+                        return QString();
+
+                const QString exactName = u"TomlObjectViewer_"_s + language + u".qm"_s;
+                if (available.contains(exactName))
+                        return exactName;
+
+                // en -> en_US: любой перевод на тот же язык
+                const QString languagePrefix = u"TomlObjectViewer_"_s + languageCode + '_';
+                for (const QString &fileName : available) {
+                        if (fileName.startsWith(languagePrefix))
+                                return fileName;
+                }
+        }
+        return QString();
+}
+
+static void
+installTranslation(QTranslator &translator, const QLocale &locale)
+{
+        QCoreApplication::removeTranslator(&translator);
+
+        // Если перевод не найден, остаются исходные (русские) строки
+        const QString fileName = translationFile(locale);
+        if (!fileName.isEmpty() && translator.load(fileName, u":/i18n"_s))
+                QCoreApplication::installTranslator(&translator);
+}
+
+// Экспорт из командной строки выполняется без окна, поэтому для него
+// достаточно QCoreApplication и не требуется графическая среда
+static bool
+isBatchExport(int argc, char *argv[])
+{
+        for (int i = 1; i < argc; ++i) {
+                const std::string_view arg(argv[i]);
+                if (arg == "--export" || arg.substr(0, 9) == "--export=")
+                        return true;
+        }
+        return false;
+}
+
+static int
+exportObject(const QString &inputPath, const QString &outputPath, const QString &formatName)
+{
+        QTextStream err(stderr);
+
+        const std::optional<ObjectExporter::Format> format =
+            formatName.isEmpty() ? ObjectExporter::formatForPath(outputPath)
+                                 : ObjectExporter::formatForName(formatName);
+        if (!format) {
+                err << u"Неизвестный формат экспорта. Допустимые форматы: json, csv, toml."_s
+                    << '\n';
+                return EXIT_FAILURE;
+        }
+
+        // Модель с деревом элементов для экспорта не нужна: снимок строится
+        // прямо из проверенного файла
+        try {
+                const std::shared_ptr<const ObjectSnapshot> snapshot =
+                    ObjectSnapshot::fromToml(TreeModel::parseFile(inputPath));
+                ObjectExporter::exportObject(*snapshot, outputPath, *format);
+        } catch (const std::runtime_error &e) {
+                err << TreeModel::loadErrorMessage(e) << '\n';
+                return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+}
 
 int
 main(int argc, char *argv[])
 {
-        QApplication a(argc, argv);
+        // Отсчёт для --measure-startup
+        QElapsedTimer mainTimer;
+        mainTimer.start();
 
-        QTranslator translator;
+        std::unique_ptr<QCoreApplication> a;
+        if (isBatchExport(argc, argv))
+                a = std::make_unique<QCoreApplication>(argc, argv);
+        else
+                a = std::make_unique<QApplication>(argc, argv);
+
+        QCommandLineParser parser;
+        parser.setApplicationDescription(u"Просмотр объектов, описанных в формате TOML."_s);
+        parser.addHelpOption();
+        parser.addPositionalArgument(u"file"_s, u"TOML-файл объекта."_s, u"[file]"_s);
+
+        const QCommandLineOption exportOption(
+            u"export"_s,
+            u"Экспортировать объект из <file> в <output> и завершить работу."_s,
+            u"output"_s);
+        const QCommandLineOption exportFormatOption(
+            u"export-format"_s,
+            u"Формат экспорта: json, csv или toml (по умолчанию - по расширению <output>)."_s,
+            u"format"_s);
+        const QCommandLineOption controlServerOption(
+            u"control-server"_s,
+            u"Запустить локальный сервер управления с именем <name> (см. tomlobjectctl)."_s,
+            u"name"_s);
+        const QCommandLineOption measureStartupOption(
+            u"measure-startup"_s,
+            u"Вывести время до первой отрисовки окна и до первого кадра с объектом и "
+            u"завершить работу."_s);
+        parser.addOption(exportOption);
+        parser.addOption(exportFormatOption);
+        parser.addOption(controlServerOption);
+        parser.addOption(measureStartupOption);
 
-        QLocale           locale             = QLocale::system();
-        QString           languageAndCountry = locale.name();
-        QString           languageCode       = languageAndCountry.split('_').first();
-        const QStringList uiLanguages        = locale.uiLanguages();
-        for (const QString &locale : uiLanguages) {
-                const QString baseName = "TomlObjectViewer_" + QLocale(locale).name();
-                if (translator.load(":/i18n/" + baseName)) {
-                        a.installTranslator(&translator);
-                        break;
+        parser.process(*a);
+
+        if (parser.isSet(exportOption)) {
+                const QStringList positionalArguments = parser.positionalArguments();
+                if (positionalArguments.size() != 1) {
+                        QTextStream(stderr)
+                            << u"Для экспорта требуется указать один TOML-файл."_s << '\n';
+                        return EXIT_FAILURE;
                 }
+                return exportObject(positionalArguments.first(),
+                                    parser.value(exportOption),
+                                    parser.value(exportFormatOption));
         }
 
+        // Разбор файла из командной строки идёт параллельно с загрузкой
+        // перевода и созданием окна
+        const QStringList              positionalArguments = parser.positionalArguments();
+        QFuture<TreeModel::LoadResult> initialLoad;
+        if (!positionalArguments.isEmpty())
+                initialLoad = QtConcurrent::run(&TreeModel::loadFile, positionalArguments.first());
+
+        QTranslator translator;
+        installTranslation(translator, QLocale::system());
+
         MainWindow w;
+        QObject::connect(&w,
+                         &MainWindow::languageChangeRequested,
+                         &w,
+                         [&translator](const QLocale &locale) {
+                                 installTranslation(translator, locale);
+                         });
+        if (parser.isSet(controlServerOption))
+                w.startControlServer(parser.value(controlServerOption));
+        if (parser.isSet(measureStartupOption))
+                new StartupMeter(mainTimer, &w, !positionalArguments.isEmpty());
+        if (!positionalArguments.isEmpty())
+                w.openFileAsync(positionalArguments.first(), initialLoad);
         w.show();
 
-        return a.exec();
+        return a->exec();
 }
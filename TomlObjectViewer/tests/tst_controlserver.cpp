@@ -0,0 +1,261 @@
+// Проверка сервера управления через ControlClient: пакетные запросы,
+// отказ от пакета целиком, подписка и пропускная способность конвейера.
+//
+// Сервер работает в потоке теста с циклом событий, клиенты - в потоке пула:
+// ожидание ответа в ControlClient блокирующее и не может выполняться в том
+// же потоке, что и сервер.
+
+#include "ControlClient.h"
+#include "ControlServer.h"
+#include "TreeModel.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFutureWatcher>
+#include <QStandardPaths>
+#include <QTimer>
+#include <QtConcurrent>
+#include <QtTest>
+
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+
+const QString processorId = u"процессор"_s;
+const QString memoryId    = u"объём оперативной памяти"_s;
+const QString graphicsId  = u"графический процессор"_s;
+
+// Число запросов в замере пропускной способности
+constexpr int pipelinedRequests = 10000;
+
+struct Notification
+{
+        QString id;
+        QString value;
+};
+
+}    // namespace
+
+class tst_ControlServer : public QObject
+{
+        Q_OBJECT
+
+private slots:
+        void initTestCase();
+        void init();
+        void cleanupTestCase();
+
+        void batchedGetSet();
+        void rejectedBatch();
+        void subscription();
+        void pipelinedThroughput();
+
+private:
+        // Выполняет function(client) в потоке пула с клиентом, подключённым
+        // к серверу, и обрабатывает события сервера до её завершения.
+        // Пустой результат - не удалось подключиться или истекло время.
+        template<typename Function>
+        std::optional<std::invoke_result_t<Function, ControlClient &>>
+        runClient(Function function, int msecs = 30000);
+
+        TreeModel      m_model;
+        ControlServer *m_server = nullptr;
+        QString        m_serverName;
+};
+
+template<typename Function>
+std::optional<std::invoke_result_t<Function, ControlClient &>>
+tst_ControlServer::runClient(Function function, int msecs)
+{
+        using Result = std::invoke_result_t<Function, ControlClient &>;
+
+        const QString                  serverName = m_serverName;
+        QFuture<std::optional<Result>> future =
+            QtConcurrent::run([serverName, function]() -> std::optional<Result> {
+                    ControlClient client;
+                    if (!client.connectToServer(serverName))
+                            return std::nullopt;
+                    return function(client);
+            });
+
+        QFutureWatcher<std::optional<Result>> watcher;
+        QEventLoop                            loop;
+        connect(&watcher, &QFutureWatcherBase::finished, &loop, &QEventLoop::quit);
+        watcher.setFuture(future);
+        QTimer::singleShot(msecs, &loop, &QEventLoop::quit);
+        if (!future.isFinished())
+                loop.exec();
+
+        if (!future.isFinished()) {
+                // Клиент не дождётся ответа без цикла событий сервера
+                while (!future.isFinished())
+                        QCoreApplication::processEvents();
+                return std::nullopt;
+        }
+        return future.result();
+}
+
+void
+tst_ControlServer::initTestCase()
+{
+        // Кэш базовых объектов (BaseCache) не должен попадать в каталог пользователя
+        QStandardPaths::setTestModeEnabled(true);
+
+        m_serverName = u"tst_controlserver_%1"_s.arg(QCoreApplication::applicationPid());
+        m_server     = new ControlServer(m_model, this);
+        QVERIFY2(m_server->listen(m_serverName), qPrintable(m_server->errorString()));
+}
+
+void
+tst_ControlServer::init()
+{
+        m_model.reset(QStringLiteral(DATA_EXAMPLES_DIR "/constrained_object_example.toml"));
+        QCOMPARE(m_model.parameterValue(processorId), u"Intel Core i5"_s);
+}
+
+void
+tst_ControlServer::cleanupTestCase()
+{
+        delete m_server;
+        m_server = nullptr;
+}
+
+void
+tst_ControlServer::batchedGetSet()
+{
+        const auto responses = runClient([](ControlClient &client) {
+                QList<ControlProtocol::Response> result(3);
+                const quint32 before = client.get({ processorId, memoryId, graphicsId });
+                const quint32 set    = client.set({ { processorId, u"Intel Core i7"_s },
+                                                    { graphicsId, u"NVIDIA GeForce"_s } });
+                const quint32 after  = client.get({ processorId, graphicsId });
+                if (!client.waitForResponse(before, &result[0]) ||
+                    !client.waitForResponse(set, &result[1]) ||
+                    !client.waitForResponse(after, &result[2]))
+                        result.clear();
+                return result;
+        });
+        QVERIFY(responses.has_value());
+        QCOMPARE(responses->size(), 3);
+
+        QCOMPARE((*responses)[0].status, ControlProtocol::Status::Ok);
+        QCOMPARE((*responses)[0].data,
+                 QStringList({ u"Intel Core i5"_s, u"16"_s, u"Встроенный"_s }));
+        QCOMPARE((*responses)[1].status, ControlProtocol::Status::Ok);
+        QCOMPARE((*responses)[2].status, ControlProtocol::Status::Ok);
+        QCOMPARE((*responses)[2].data, QStringList({ u"Intel Core i7"_s, u"NVIDIA GeForce"_s }));
+
+        QCOMPARE(m_model.parameterValue(processorId), u"Intel Core i7"_s);
+        QCOMPARE(m_model.parameterValue(graphicsId), u"NVIDIA GeForce"_s);
+}
+
+void
+tst_ControlServer::rejectedBatch()
+{
+        // Каждое значение допустимо само по себе, но вместе они нарушают
+        // правило "Intel Core i3 -> не более 16 ГБ памяти"
+        const auto responses = runClient([](ControlClient &client) {
+                QList<ControlProtocol::Response> result(2);
+                const quint32 set = client.set(
+                    { { memoryId, u"32"_s }, { processorId, u"Intel Core i3"_s } });
+                const quint32 get = client.get({ processorId, memoryId });
+                if (!client.waitForResponse(set, &result[0]) ||
+                    !client.waitForResponse(get, &result[1]))
+                        result.clear();
+                return result;
+        });
+        QVERIFY(responses.has_value());
+        QCOMPARE(responses->size(), 2);
+
+        QCOMPARE((*responses)[0].status, ControlProtocol::Status::Error);
+        QCOMPARE((*responses)[0].data.size(), 1);
+        QCOMPARE((*responses)[1].status, ControlProtocol::Status::Ok);
+        QCOMPARE((*responses)[1].data, QStringList({ u"Intel Core i5"_s, u"16"_s }));
+
+        QCOMPARE(m_model.parameterValue(processorId), u"Intel Core i5"_s);
+        QCOMPARE(m_model.parameterValue(memoryId), u"16"_s);
+}
+
+void
+tst_ControlServer::subscription()
+{
+        const auto notifications = runClient([](ControlClient &client) {
+                QList<Notification> result;
+                QObject::connect(&client,
+                                 &ControlClient::parameterValueChanged,
+                                 [&result](const QString &id, const QString &value) {
+                                         result.append({ id, value });
+                                 });
+
+                ControlProtocol::Response response;
+                if (!client.waitForResponse(client.subscribe(), &response))
+                        return result;
+                // Уведомление отправляется до ответа на запрос Set
+                client.waitForResponse(client.set({ { processorId, u"Intel Core i7"_s } }),
+                                       &response);
+                client.waitForResponse(client.unsubscribe(), &response);
+                // После отписки уведомлений нет
+                client.waitForResponse(client.set({ { processorId, u"Intel Core i3"_s } }),
+                                       &response);
+                client.waitForResponse(client.get({ processorId }), &response);
+                return result;
+        });
+        QVERIFY(notifications.has_value());
+        QCOMPARE(notifications->size(), 1);
+        QCOMPARE(notifications->first().id, processorId);
+        QCOMPARE(notifications->first().value, u"Intel Core i7"_s);
+
+        QCOMPARE(m_model.parameterValue(processorId), u"Intel Core i3"_s);
+}
+
+void
+tst_ControlServer::pipelinedThroughput()
+{
+        struct Run
+        {
+                int    answered = 0;
+                qint64 nsecs    = 0;
+        };
+
+        const auto run = runClient([](ControlClient &client) {
+                Run result;
+
+                QElapsedTimer timer;
+                timer.start();
+
+                // Все запросы отправляются до ожидания первого ответа
+                QList<quint32> requests;
+                requests.reserve(pipelinedRequests);
+                for (int i = 0; i < pipelinedRequests; ++i)
+                        requests.append(client.get({ i % 2 == 0 ? processorId : memoryId }));
+
+                ControlProtocol::Response response;
+                for (const quint32 requestId : std::as_const(requests)) {
+                        if (!client.waitForResponse(requestId, &response) ||
+                            response.status != ControlProtocol::Status::Ok)
+                                break;
+                        ++result.answered;
+                }
+
+                result.nsecs = timer.nsecsElapsed();
+                return result;
+        });
+        QVERIFY(run.has_value());
+        QCOMPARE(run->answered, pipelinedRequests);
+
+        const double seconds = double(run->nsecs) / 1e9;
+        qInfo("%d запросов за %.3f с: %.0f запросов/с",
+              pipelinedRequests,
+              seconds,
+              pipelinedRequests / seconds);
+}
+
+QTEST_GUILESS_MAIN(tst_ControlServer)
+
+#include "tst_controlserver.moc"
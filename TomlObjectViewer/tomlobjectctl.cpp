@@ -0,0 +1,113 @@
+// Утилита командной строки для сервера управления TomlObjectViewer.
+//
+//   tomlobjectctl [--server <name>] list
+//   tomlobjectctl [--server <name>] get <id>...
+//   tomlobjectctl [--server <name>] set <id>=<value>...
+//   tomlobjectctl [--server <name>] watch
+
+#include "ControlClient.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+
+#include <cstdlib>
+
+using namespace Qt::StringLiterals;
+
+static int
+printResponse(ControlClient &client, quint32 requestId)
+{
+        ControlProtocol::Response response;
+        if (!client.waitForResponse(requestId, &response)) {
+                QTextStream(stderr) << u"Нет ответа от сервера: "_s << client.errorString() << '\n';
+                return EXIT_FAILURE;
+        }
+
+        if (response.status == ControlProtocol::Status::Error) {
+                QTextStream(stderr) << response.data.value(0) << '\n';
+                return EXIT_FAILURE;
+        }
+
+        QTextStream out(stdout);
+        for (const QString &line : std::as_const(response.data))
+                out << line << '\n';
+        return EXIT_SUCCESS;
+}
+
+int
+main(int argc, char *argv[])
+{
+        QCoreApplication app(argc, argv);
+
+        QCommandLineParser parser;
+        parser.setApplicationDescription(
+            u"Чтение и изменение параметров объекта, открытого в TomlObjectViewer."_s);
+        parser.addHelpOption();
+        parser.addPositionalArgument(u"command"_s, u"list, get, set или watch."_s);
+        parser.addPositionalArgument(u"arguments"_s,
+                                     u"Идентификаторы (get) или пары <id>=<value> (set)."_s,
+                                     u"[arguments...]"_s);
+
+        const QCommandLineOption serverOption(u"server"_s,
+                                              u"Имя сервера управления."_s,
+                                              u"name"_s,
+                                              QString::fromLatin1(
+                                                  ControlProtocol::defaultServerName));
+        parser.addOption(serverOption);
+        parser.process(app);
+
+        QStringList arguments = parser.positionalArguments();
+        if (arguments.isEmpty())
+                parser.showHelp(EXIT_FAILURE);
+        const QString command = arguments.takeFirst();
+
+        ControlClient client;
+        if (!client.connectToServer(parser.value(serverOption))) {
+                QTextStream(stderr) << u"Не удалось подключиться к серверу: "_s
+                                    << client.errorString() << '\n';
+                return EXIT_FAILURE;
+        }
+
+        if (command == u"list"_s)
+                return printResponse(client, client.listParameters());
+
+        if (command == u"get"_s)
+                return printResponse(client, client.get(arguments));
+
+        if (command == u"set"_s) {
+                QList<std::pair<QString, QString>> values;
+                for (const QString &argument : std::as_const(arguments)) {
+                        const qsizetype separator = argument.indexOf(u'=');
+                        if (separator < 0) {
+                                QTextStream(stderr) << u"Ожидается <id>=<value>: "_s << argument
+                                                    << '\n';
+                                return EXIT_FAILURE;
+                        }
+                        values.append({ argument.left(separator), argument.mid(separator + 1) });
+                }
+                return printResponse(client, client.set(values));
+        }
+
+        if (command == u"watch"_s) {
+                QTextStream out(stdout);
+                QObject::connect(&client,
+                                 &ControlClient::parameterValueChanged,
+                                 &app,
+                                 [&out](const QString &id, const QString &value) {
+                                         out << id << '\t' << value << Qt::endl;
+                                 });
+                QObject::connect(&client,
+                                 &ControlClient::disconnected,
+                                 &app,
+                                 &QCoreApplication::quit);
+
+                ControlProtocol::Response response;
+                if (!client.waitForResponse(client.subscribe(), &response))
+                        return EXIT_FAILURE;
+                return app.exec();
+        }
+
+        QTextStream(stderr) << u"Неизвестная команда: "_s << command << '\n';
+        return EXIT_FAILURE;
+}